@@ -0,0 +1,718 @@
+/* Throughput of every hashing algorithm.
+ *
+ * For each algorithm:
+ *   <ALGO>/single/<size>       one update() of <size> bytes then getHash(), hasher included
+ *   <ALGO>/oneshot/<size>      the same through the one-shot function, e.g. crypto::sha256()
+ *   <ALGO>/stream/<chunk>      a 1 MiB stream fed through update() in <chunk> bytes pieces
+ *   <ALGO>/many/<size>         4096 independent messages of <size> bytes, one hasher each
+ *   <ALGO>/pooled/<size>       the same messages, each on a hasher leased from HasherPool
+ *   <ALGO>/multibuffer/<size>  the same messages through multibuffer::hashMany (when supported)
+ *   <ALGO>/static/<size>       single-shot with the header-only StaticHasher of the algorithm
+ *   <ALGO>/static-many/<size>  the 4096 small messages with StaticHasher
+ *   <ALGO>/hmac/<size>         the 4096 small messages signed by HMAC::signMany under one key
+ *   <ALGO>/kernel/<name>/<size>
+ *                              raw compression function over 1 KiB and 1 MiB of blocks:
+ *                              "legacy" is the former loop (bench/legacy_kernels.hpp),
+ *                              "portable" the current scalar kernel, "ssse3"/"avx2" the scalar
+ *                              rounds fed by a vectorized message schedule, "shani" the SHA
+ *                              extensions (when supported)
+ *   <ALGO>/tree/<size>         TreeHashing over <size> bytes with 1 MiB leaves on the shared pool
+ *
+ * The hashers use the kernels picked by the runtime dispatcher, reported in the context
+ * header; set CRYPTO_KERNEL (see include/Dispatch.hpp) to measure them with another one.
+ *
+ * Every benchmark reports bytes_per_second, "GB" (a rate, in GB/s) and "cycles/byte" (time stamp
+ * counter ticks on x86, 0 elsewhere). The single-shot sweep goes up to 1 GiB;
+ * use --benchmark_filter to skip the largest sizes and
+ * --benchmark_out=<file> --benchmark_out_format=json to keep the results.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "MD4.hpp"
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA224.hpp"
+#include "SHA256.hpp"
+#include "SHA384.hpp"
+#include "SHA512.hpp"
+#include "MultiBuffer.hpp"
+#include "TreeHashing.hpp"
+#include "StaticHasher.hpp"
+#include "HMAC.hpp"
+#include "Dispatch.hpp"
+#include "HasherPool.hpp"
+#include "OneShot.hpp"
+#include "MultiDigest.hpp"
+#include "Hex.hpp"
+#include "Chunker.hpp"
+#include "HashFile.hpp"
+#include "AsyncHashFile.hpp"
+#include "DigestCache.hpp"
+#include "HashingStreambuf.hpp"
+#include "SHA1Kernel.hpp"
+#include "SHA256224Kernel.hpp"
+#include "SHA512384Kernel.hpp"
+#include "legacy_kernels.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+const size_t STREAM_SIZE = 1 << 20;
+const size_t MANY_COUNT = 4096;
+
+/* Shared input data, grown on demand to the largest size requested so far.
+ **/
+const uint8_t* input(size_t size)
+{
+    static std::vector<uint8_t> buffer;
+
+    if (buffer.size() < size) {
+        auto old = buffer.size();
+        buffer.resize(size);
+        for (auto i = old; i < size; ++i) {
+            buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+        }
+    }
+
+    return buffer.data();
+}
+
+uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Runs body once per iteration and reports the throughput for bytesPerIteration.
+ **/
+template <typename F>
+void measure(benchmark::State& state, size_t bytesPerIteration, F body)
+{
+    auto start = cycles();
+    for (auto _ : state) {
+        body();
+    }
+    auto elapsed = cycles() - start;
+
+    auto bytes = static_cast<double>(state.iterations()) * bytesPerIteration;
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["GB"] = benchmark::Counter(bytes / 1e9, benchmark::Counter::kIsRate);
+    state.counters["cycles/byte"] = bytes > 0 ? elapsed / bytes : 0;
+}
+
+template <typename Hasher>
+void singleShot(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+
+    measure(state, size, [&] {
+        Hasher strategy;
+        gsl::span<const uint8_t> message { data, static_cast<std::ptrdiff_t>(size) };
+        strategy.update(message);
+        benchmark::DoNotOptimize(strategy.getHash());
+    });
+}
+
+template <typename OneShot>
+void oneShot(benchmark::State& state, OneShot hash)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+
+    measure(state, size, [&] {
+        gsl::span<const uint8_t> message { data, static_cast<std::ptrdiff_t>(size) };
+        benchmark::DoNotOptimize(hash(message));
+    });
+}
+
+template <typename OneShot>
+void registerOneShot(const std::string& name, OneShot hash)
+{
+    benchmark::RegisterBenchmark((name + "/oneshot").c_str(), [hash](benchmark::State& state) {
+        oneShot(state, hash);
+    })->RangeMultiplier(4)->Range(16, 1 << 20);
+}
+
+template <typename Hasher>
+void streaming(benchmark::State& state)
+{
+    const auto chunk = static_cast<std::ptrdiff_t>(state.range(0));
+    const auto data = input(STREAM_SIZE);
+    Hasher strategy;
+
+    measure(state, STREAM_SIZE, [&] {
+        gsl::span<const uint8_t> in { data, static_cast<std::ptrdiff_t>(STREAM_SIZE) };
+        while (!in.empty()) {
+            auto piece = in.first(std::min(chunk, in.size()));
+            strategy.update(piece);
+            in = in.subspan(piece.size());
+        }
+        benchmark::DoNotOptimize(strategy.getHash());
+    });
+}
+
+std::vector<gsl::span<const uint8_t>> messages(size_t size)
+{
+    const auto data = input(size * MANY_COUNT);
+
+    std::vector<gsl::span<const uint8_t>> msgs;
+    for (size_t i = 0; i < MANY_COUNT; ++i) {
+        msgs.emplace_back(data + i * size, static_cast<std::ptrdiff_t>(size));
+    }
+    return msgs;
+}
+
+template <typename Hasher>
+void manySmall(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    auto msgs = messages(size);
+
+    measure(state, size * MANY_COUNT, [&] {
+        for (auto& msg : msgs) {
+            Hasher strategy;
+            strategy.update(msg);
+            benchmark::DoNotOptimize(strategy.getHash());
+        }
+    });
+}
+
+template <typename Hasher>
+void pooledSmall(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    auto msgs = messages(size);
+
+    measure(state, size * MANY_COUNT, [&] {
+        for (auto& msg : msgs) {
+            auto strategy = crypto::HasherPool<Hasher>::acquire();
+            strategy->update(msg);
+            benchmark::DoNotOptimize(strategy->getHash());
+        }
+    });
+}
+
+template <typename Hasher>
+void multiBuffer(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    auto msgs = messages(size);
+    std::vector<crypto::multibuffer::Digest<Hasher>> digests(msgs.size());
+
+    measure(state, size * MANY_COUNT, [&] {
+        crypto::multibuffer::hashMany<Hasher>(msgs, digests);
+        benchmark::DoNotOptimize(digests.data());
+    });
+
+    state.counters["lanes"] = static_cast<double>(crypto::multibuffer::lanes<Hasher>());
+}
+
+template <typename Hasher>
+void records(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size * MANY_COUNT);
+    std::vector<crypto::multibuffer::Digest<Hasher>> digests(MANY_COUNT);
+
+    measure(state, size * MANY_COUNT, [&] {
+        crypto::multibuffer::hashRecords<Hasher>(data, size, size, MANY_COUNT, digests);
+        benchmark::DoNotOptimize(digests.data());
+    });
+
+    state.counters["lanes"] = static_cast<double>(crypto::multibuffer::lanes<Hasher>());
+}
+
+template <typename Hasher>
+void hmacMany(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    auto msgs = messages(size);
+    const uint8_t key[32] = {};
+    crypto::HMAC<Hasher> hmac(key);
+    std::vector<typename crypto::HMAC<Hasher>::Digest> macs(msgs.size());
+
+    measure(state, size * MANY_COUNT, [&] {
+        hmac.signMany(msgs, macs);
+        benchmark::DoNotOptimize(macs.data());
+    });
+}
+
+/* Throughput of a bare compression function, without padding nor buffering.
+ **/
+template <typename State, typename Compress>
+void kernel(benchmark::State& state, State initial, Compress compress, size_t blockSize)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+    auto chaining = initial;
+
+    measure(state, size, [&] {
+        compress(chaining, data, size / blockSize);
+        benchmark::DoNotOptimize(chaining);
+    });
+}
+
+template <typename Hasher>
+void treeHash(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    gsl::span<const uint8_t> message { input(size), static_cast<std::ptrdiff_t>(size) };
+    crypto::TreeHashing<Hasher> tree;
+
+    measure(state, size, [&] {
+        tree.update(message);
+        benchmark::DoNotOptimize(tree.getHash());
+    });
+
+    state.counters["threads"] = static_cast<double>(crypto::ThreadPool::shared().size());
+}
+
+template <typename Hasher>
+void registerAlgorithm(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/single").c_str(), singleShot<Hasher>)
+        ->RangeMultiplier(4)->Range(16, 1 << 30);
+
+    benchmark::RegisterBenchmark((name + "/stream").c_str(), streaming<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(256)->Arg(4096);
+
+    benchmark::RegisterBenchmark((name + "/many").c_str(), manySmall<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(200)->Arg(1024);
+
+    benchmark::RegisterBenchmark((name + "/pooled").c_str(), pooledSmall<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(200)->Arg(1024);
+}
+
+template <typename Hasher>
+void registerMultiBuffer(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/multibuffer").c_str(), multiBuffer<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(200)->Arg(1024);
+    benchmark::RegisterBenchmark((name + "/records").c_str(), records<Hasher>)
+        ->Arg(16)->Arg(32)->Arg(64)->Arg(200)->UseRealTime();
+}
+
+template <typename Hasher>
+void registerStatic(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/static").c_str(), singleShot<Hasher>)
+        ->RangeMultiplier(4)->Range(16, 1 << 20);
+
+    benchmark::RegisterBenchmark((name + "/static-many").c_str(), manySmall<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(200)->Arg(1024);
+}
+
+template <typename Hasher>
+void registerHMAC(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/hmac").c_str(), hmacMany<Hasher>)
+        ->Arg(16)->Arg(64)->Arg(200)->Arg(1024);
+}
+
+template <typename Hasher>
+void registerTreeHash(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/tree").c_str(), treeHash<Hasher>)
+        ->RangeMultiplier(8)->Range(1 << 20, 1 << 30)->UseRealTime();
+}
+
+/* MD5, SHA-1 and SHA-256 of the same input, with one pass per algorithm or a single
+ * MultiDigest pass (on the shared pool when parallel).
+ **/
+void digestsSeparate(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+
+    measure(state, size, [&] {
+        gsl::span<const uint8_t> message { data, static_cast<std::ptrdiff_t>(size) };
+        crypto::MD5hashing md5;
+        crypto::SHA1hashing sha1;
+        crypto::SHA256hashing sha256;
+        md5.update(message);
+        sha1.update(message);
+        sha256.update(message);
+        benchmark::DoNotOptimize(md5.getHash());
+        benchmark::DoNotOptimize(sha1.getHash());
+        benchmark::DoNotOptimize(sha256.getHash());
+    });
+}
+
+void digestsSinglePass(benchmark::State& state, bool parallel)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+
+    measure(state, size, [&] {
+        gsl::span<const uint8_t> message { data, static_cast<std::ptrdiff_t>(size) };
+        crypto::MultiDigest multi({ crypto::HashAlgorithm::MD5, crypto::HashAlgorithm::SHA1, crypto::HashAlgorithm::SHA256 },
+                                  parallel ? &crypto::ThreadPool::shared() : nullptr);
+        multi.update(message);
+        benchmark::DoNotOptimize(multi.getHashes());
+    });
+}
+
+/* Content-defined chunking with per-chunk digests of a size bytes stream, given in 1 MiB
+ * pieces, the chunks hashed on the calling thread or on the shared pool.
+ **/
+template <typename Hasher>
+void chunker(benchmark::State& state, bool parallel)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = input(size);
+    size_t chunks = 0;
+
+    measure(state, size, [&] {
+        crypto::Chunker<Hasher> chunker([&chunks](const typename crypto::Chunker<Hasher>::Chunk&) { ++chunks; },
+                                        crypto::ChunkerOptions(), parallel ? &crypto::ThreadPool::shared() : nullptr);
+        for (size_t offset = 0; offset < size; offset += STREAM_SIZE) {
+            gsl::span<const uint8_t> piece { data + offset, static_cast<std::ptrdiff_t>(std::min(STREAM_SIZE, size - offset)) };
+            chunker.update(piece);
+        }
+        chunker.finish();
+    });
+    benchmark::DoNotOptimize(chunks);
+}
+
+// drops what is written to it
+class NullStreambuf : public std::streambuf
+{
+    protected:
+
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/* A 1 MiB stream written through std::ostream in <chunk> bytes pieces, hashed on its way
+ * to a stream buffer which drops it.
+ **/
+template <typename Hasher>
+void ostreamWrites(benchmark::State& state)
+{
+    const auto chunk = static_cast<size_t>(state.range(0));
+    const auto data = reinterpret_cast<const char*>(input(STREAM_SIZE));
+
+    NullStreambuf sink;
+    crypto::HashingStreambuf<Hasher> hashing(&sink);
+    std::ostream out(&hashing);
+    measure(state, STREAM_SIZE, [&] {
+        for (size_t offset = 0; offset < STREAM_SIZE; offset += chunk) {
+            out.write(data + offset, static_cast<std::streamsize>(std::min(chunk, STREAM_SIZE - offset)));
+        }
+        benchmark::DoNotOptimize(hashing.getHash());
+    });
+}
+
+/* Text of size bytes (a digest or a longer buffer) with operator<< or toHex(), and back.
+ **/
+void hexStream(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const gsl::span<const uint8_t> bytes { input(size), static_cast<std::ptrdiff_t>(size) };
+
+    std::ostringstream stream;
+    measure(state, size, [&] {
+        stream.str(std::string());
+        crypto::operator<<(stream, bytes);
+        benchmark::DoNotOptimize(stream.str().data());
+    });
+}
+
+void hexEncode(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const gsl::span<const uint8_t> bytes { input(size), static_cast<std::ptrdiff_t>(size) };
+
+    std::vector<char> text(2 * size);
+    measure(state, size, [&] {
+        crypto::toHex(bytes, text.data());
+        benchmark::DoNotOptimize(text.data());
+    });
+}
+
+void hexDecode(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const gsl::span<const uint8_t> bytes { input(size), static_cast<std::ptrdiff_t>(size) };
+
+    std::vector<char> text(2 * size);
+    crypto::toHex(bytes, text.data());
+    std::vector<uint8_t> decoded(size);
+    measure(state, size, [&] {
+        benchmark::DoNotOptimize(crypto::fromHex(text, decoded.data()));
+    });
+}
+
+void digestEquals(benchmark::State& state)
+{
+    crypto::SHA256hash a = crypto::sha256(gsl::span<const uint8_t>());
+    auto b = a;
+    measure(state, a.size(), [&] {
+        benchmark::DoNotOptimize(crypto::equals(a, b));
+    });
+}
+
+/* A set of count files of size bytes each in the temporary directory, removed at exit.
+ **/
+const std::vector<std::string>& fileSet(size_t count, size_t size)
+{
+    struct Files
+    {
+        std::vector<std::string> paths;
+
+        ~Files()
+        {
+            for (const auto& path : paths) {
+                std::remove(path.c_str());
+            }
+        }
+    };
+    static Files files;
+
+    if (files.paths.size() != count) {
+        for (const auto& path : files.paths) {
+            std::remove(path.c_str());
+        }
+        files.paths.clear();
+        for (size_t i = 0; i < count; ++i) {
+            auto path = "/tmp/bench-crypto-" + std::to_string(i);
+            auto file = std::fopen(path.c_str(), "wb");
+            if (file) {
+                std::fwrite(input(size), 1, size, file);
+                std::fclose(file);
+            }
+            files.paths.push_back(path);
+        }
+    }
+
+    return files.paths;
+}
+
+template <typename Hasher>
+void filesSequential(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto& paths = fileSet(count, STREAM_SIZE);
+
+    measure(state, count * STREAM_SIZE, [&] {
+        for (const auto& path : paths) {
+            Hasher hasher;
+            crypto::hashFile(path, hasher);
+            benchmark::DoNotOptimize(hasher.getHash());
+        }
+    });
+}
+
+template <typename Hasher>
+void filesAsync(benchmark::State& state, bool useIoUring)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto& paths = fileSet(count, STREAM_SIZE);
+
+    crypto::AsyncHashOptions options;
+    options.useIoUring = useIoUring;
+    measure(state, count * STREAM_SIZE, [&] {
+        crypto::hashFilesAsync<Hasher>(paths, [](size_t, bool, const decltype(std::declval<Hasher&>().getHash())& digest) {
+            benchmark::DoNotOptimize(digest);
+        }, nullptr, options);
+    });
+}
+
+// an unchanged tree hashed again: stat() and a lookup per file
+template <typename Hasher>
+void filesCached(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto& paths = fileSet(count, STREAM_SIZE);
+
+    const std::string index = "/tmp/bench-crypto-index";
+    std::remove(index.c_str());
+    crypto::DigestCacheOptions options;
+    // the files were just written
+    options.racyWindowNs = 0;
+    crypto::DigestCache cache(index, options);
+    for (const auto& path : paths) {
+        decltype(std::declval<Hasher&>().getHash()) digest;
+        cache.hashFile<Hasher>(path, digest);
+    }
+
+    measure(state, count * STREAM_SIZE, [&] {
+        for (const auto& path : paths) {
+            decltype(std::declval<Hasher&>().getHash()) digest;
+            cache.hashFile<Hasher>(path, digest);
+            benchmark::DoNotOptimize(digest);
+        }
+    });
+    std::remove(index.c_str());
+}
+
+template <typename Hasher>
+void registerFiles(const std::string& name)
+{
+    benchmark::RegisterBenchmark((name + "/files/sequential").c_str(), filesSequential<Hasher>)
+        ->Arg(64)->UseRealTime();
+    benchmark::RegisterBenchmark((name + "/files/async-pread").c_str(), [](benchmark::State& state) {
+        filesAsync<Hasher>(state, false);
+    })->Arg(64)->UseRealTime();
+    benchmark::RegisterBenchmark((name + "/files/async-uring").c_str(), [](benchmark::State& state) {
+        filesAsync<Hasher>(state, true);
+    })->Arg(64)->UseRealTime();
+    benchmark::RegisterBenchmark((name + "/files/cached").c_str(), filesCached<Hasher>)
+        ->Arg(64)->UseRealTime();
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[])
+{
+    // the hashers run the kernels bound by the dispatcher, CRYPTO_KERNEL included
+    benchmark::AddCustomContext("kernels", crypto::dispatch::describe());
+
+    registerAlgorithm<crypto::MD4hashing>("MD4");
+    registerAlgorithm<crypto::MD5hashing>("MD5");
+    registerAlgorithm<crypto::SHA1hashing>("SHA1");
+    registerAlgorithm<crypto::SHA224hashing>("SHA224");
+    registerAlgorithm<crypto::SHA256hashing>("SHA256");
+    registerAlgorithm<crypto::SHA384hashing>("SHA384");
+    registerAlgorithm<crypto::SHA512hashing>("SHA512");
+
+    registerMultiBuffer<crypto::MD5hashing>("MD5");
+    registerMultiBuffer<crypto::SHA1hashing>("SHA1");
+    registerMultiBuffer<crypto::SHA256hashing>("SHA256");
+    registerMultiBuffer<crypto::SHA512hashing>("SHA512");
+
+    registerStatic<crypto::StaticMD4hashing>("MD4");
+    registerStatic<crypto::StaticMD5hashing>("MD5");
+    registerStatic<crypto::StaticSHA1hashing>("SHA1");
+    registerStatic<crypto::StaticSHA224hashing>("SHA224");
+    registerStatic<crypto::StaticSHA256hashing>("SHA256");
+    registerStatic<crypto::StaticSHA384hashing>("SHA384");
+    registerStatic<crypto::StaticSHA512hashing>("SHA512");
+
+    registerOneShot("MD4", crypto::md4);
+    registerOneShot("MD5", crypto::md5);
+    registerOneShot("SHA1", crypto::sha1);
+    registerOneShot("SHA224", crypto::sha224);
+    registerOneShot("SHA256", crypto::sha256);
+    registerOneShot("SHA384", crypto::sha384);
+    registerOneShot("SHA512", crypto::sha512);
+
+    benchmark::RegisterBenchmark("SHA1/kernel/legacy", [](benchmark::State& state) {
+        kernel(state, crypto::sha1_detail::IV, legacy::sha1Compress, 64);
+    })->Arg(1 << 10)->Arg(1 << 20);
+    benchmark::RegisterBenchmark("SHA1/kernel/portable", [](benchmark::State& state) {
+        kernel(state, crypto::sha1_detail::IV, crypto::sha1_detail::compress, 64);
+    })->Arg(1 << 10)->Arg(1 << 20);
+    if (crypto::sha1_detail::hasSSSE3()) {
+        benchmark::RegisterBenchmark("SHA1/kernel/ssse3", [](benchmark::State& state) {
+            kernel(state, crypto::sha1_detail::IV, [](std::array<uint32_t, 5>& chaining, const uint8_t* blocks, size_t nblocks) {
+                uint32_t wk[80];
+                for (; nblocks > 0; --nblocks, blocks += 64) {
+                    crypto::sha1_detail::expandSSSE3(blocks, wk);
+                    crypto::sha1_detail::compressExpanded(chaining, wk);
+                }
+            }, 64);
+        })->Arg(1 << 10)->Arg(1 << 20);
+    }
+    if (crypto::sha1_detail::hasAVX2()) {
+        benchmark::RegisterBenchmark("SHA1/kernel/avx2", [](benchmark::State& state) {
+            kernel(state, crypto::sha1_detail::IV, [](std::array<uint32_t, 5>& chaining, const uint8_t* blocks, size_t nblocks) {
+                uint32_t wk[2][80];
+                for (; nblocks >= 2; nblocks -= 2, blocks += 128) {
+                    crypto::sha1_detail::expandAVX2(blocks, wk[0], wk[1]);
+                    crypto::sha1_detail::compressExpanded(chaining, wk[0]);
+                    crypto::sha1_detail::compressExpanded(chaining, wk[1]);
+                }
+                crypto::sha1_detail::compress(chaining, blocks, nblocks);
+            }, 64);
+        })->Arg(1 << 10)->Arg(1 << 20);
+    }
+    if (crypto::sha1_detail::hasSHANI()) {
+        benchmark::RegisterBenchmark("SHA1/kernel/shani", [](benchmark::State& state) {
+            kernel(state, crypto::sha1_detail::IV, [](std::array<uint32_t, 5>& chaining, const uint8_t* blocks, size_t nblocks) {
+                crypto::sha1_detail::processBlocksSHANI(chaining.data(), blocks, nblocks);
+            }, 64);
+        })->Arg(1 << 10)->Arg(1 << 20);
+    }
+
+    benchmark::RegisterBenchmark("SHA256/kernel/legacy", [](benchmark::State& state) {
+        kernel(state, crypto::sha256224_detail::IV256, legacy::sha256Compress, 64);
+    })->Arg(1 << 10)->Arg(1 << 20);
+    benchmark::RegisterBenchmark("SHA256/kernel/portable", [](benchmark::State& state) {
+        kernel(state, crypto::sha256224_detail::IV256, crypto::sha256224_detail::compress, 64);
+    })->Arg(1 << 10)->Arg(1 << 20);
+    if (crypto::sha256224_detail::hasSHANI()) {
+        benchmark::RegisterBenchmark("SHA256/kernel/shani", [](benchmark::State& state) {
+            kernel(state, crypto::sha256224_detail::IV256, [](std::array<uint32_t, 8>& chaining, const uint8_t* blocks, size_t nblocks) {
+                crypto::sha256224_detail::processBlocksSHANI(chaining.data(), blocks, nblocks);
+            }, 64);
+        })->Arg(1 << 10)->Arg(1 << 20);
+    }
+
+    benchmark::RegisterBenchmark("SHA512/kernel/portable", [](benchmark::State& state) {
+        kernel(state, crypto::sha512384_detail::IV512, crypto::sha512384_detail::compress, 128);
+    })->Arg(1 << 10)->Arg(1 << 20);
+    if (crypto::sha512384_detail::hasAVX2()) {
+        benchmark::RegisterBenchmark("SHA512/kernel/avx2", [](benchmark::State& state) {
+            kernel(state, crypto::sha512384_detail::IV512, [](std::array<uint64_t, 8>& chaining, const uint8_t* blocks, size_t nblocks) {
+                crypto::sha512384_detail::processBlocksAVX2(chaining.data(), blocks, nblocks);
+            }, 128);
+        })->Arg(1 << 10)->Arg(1 << 20);
+    }
+
+    registerHMAC<crypto::MD5hashing>("MD5");
+    registerHMAC<crypto::SHA1hashing>("SHA1");
+    registerHMAC<crypto::SHA256hashing>("SHA256");
+    registerHMAC<crypto::SHA512hashing>("SHA512");
+
+    registerTreeHash<crypto::SHA256hashing>("SHA256");
+    registerTreeHash<crypto::SHA512hashing>("SHA512");
+
+    registerFiles<crypto::SHA256hashing>("SHA256");
+
+    benchmark::RegisterBenchmark("SHA256/chunker", [](benchmark::State& state) {
+        chunker<crypto::SHA256hashing>(state, false);
+    })->Arg(64 << 20)->UseRealTime();
+    benchmark::RegisterBenchmark("SHA256/chunker-parallel", [](benchmark::State& state) {
+        chunker<crypto::SHA256hashing>(state, true);
+    })->Arg(64 << 20)->UseRealTime();
+
+    benchmark::RegisterBenchmark("SHA256/ostream", ostreamWrites<crypto::SHA256hashing>)
+        ->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+    benchmark::RegisterBenchmark("hex/stream", hexStream)->Arg(32)->Arg(1 << 16);
+    benchmark::RegisterBenchmark("hex/encode", hexEncode)->Arg(16)->Arg(20)->Arg(28)->Arg(32)->Arg(48)->Arg(1 << 16);
+    benchmark::RegisterBenchmark("hex/decode", hexDecode)->Arg(16)->Arg(20)->Arg(28)->Arg(32)->Arg(48)->Arg(1 << 16);
+    benchmark::RegisterBenchmark("SHA256/equals", digestEquals);
+
+    benchmark::RegisterBenchmark("MD5+SHA1+SHA256/separate", digestsSeparate)
+        ->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+    benchmark::RegisterBenchmark("MD5+SHA1+SHA256/multidigest", [](benchmark::State& state) {
+        digestsSinglePass(state, false);
+    })->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+    benchmark::RegisterBenchmark("MD5+SHA1+SHA256/multidigest-parallel", [](benchmark::State& state) {
+        digestsSinglePass(state, true);
+    })->Arg(1 << 20)->Arg(64 << 20)->UseRealTime();
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#ifndef _BENCH_LEGACY_KERNELS_
+#define _BENCH_LEGACY_KERNELS_
+
+/* Former portable compression loops, kept verbatim as the baseline of the kernel benchmarks.
+ **/
+
+#include "SHA1Constants.hpp"
+#include "SHA256224Constants.hpp"
+#include "utils.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+
+namespace legacy {
+
+    using crypto::utils::rotate_left;
+    using crypto::utils::rotate_right;
+
+    // SHA-1: 80 words schedule built upfront, round functions dispatched through std::function
+    inline void sha1Compress(std::array<uint32_t, 5>& state, const uint8_t* blocks, size_t nblocks)
+    {
+        auto f1 = [](auto a, auto b, auto c) { return (a & b) | ((~a) & c); };
+        auto f2 = [](auto a, auto b, auto c) { return a ^ b ^ c; };
+        auto f3 = [](auto a, auto b, auto c) { return (a & b) | (c & (a | b)); };
+        auto f4 = f2;
+        std::function<uint32_t(uint32_t,uint32_t,uint32_t)> F[4] = {f1,f2,f3,f4};
+
+        using crypto::sha1_detail::K;
+
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            std::array<uint32_t, 80> W; // word sequence
+            uint32_t A, B, C, D, E;     // word buffers
+
+            std::memcpy(W.data(), blocks, 64);
+            std::transform(W.cbegin(),
+                           std::next(W.cbegin(), 16),
+                           W.begin(),
+                           [] (uint32_t n) { return htobe32(n); });
+
+            for (auto t = 16U; t < W.size(); ++t) {
+                W[t] = rotate_left(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16], 1);
+            }
+
+            A = state[0];
+            B = state[1];
+            C = state[2];
+            D = state[3];
+            E = state[4];
+
+            for (auto i = 0U; i < 4; ++i) {
+                for (auto t = i*W.size()/4; t < (i+1)*W.size()/4; ++t) {
+                    auto temp = rotate_left(A,5) + F[i](B,C,D) + E + W[t] + K[i];
+                    E = D;
+                    D = C;
+                    C = rotate_left(B,30);
+                    B = A;
+                    A = temp;
+                }
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+        }
+    }
+
+    // SHA-256: 64 words schedule built upfront, generic loop moving the 8 variables
+    inline void sha256Compress(std::array<uint32_t, 8>& state, const uint8_t* blocks, size_t nblocks)
+    {
+        auto CH = [](auto x, auto y, auto z) { return (x & y) ^ (~(x) & z); };
+        auto MAJ = [](auto x, auto y, auto z) { return (x & y) ^ (x & z) ^ (y & z); };
+
+        auto EP0 = [](auto x) { return rotate_right(x,2) ^ rotate_right(x,13) ^ rotate_right(x,22); };
+        auto EP1 = [](auto x) { return rotate_right(x,6) ^ rotate_right(x,11) ^ rotate_right(x,25); };
+
+        auto SIG0 = [](auto x) { return rotate_right(x,7) ^ rotate_right(x,18) ^ (x >> 3); };
+        auto SIG1 = [](auto x) { return rotate_right(x,17) ^ rotate_right(x,19) ^ (x >> 10); };
+
+        using crypto::sha256224_detail::K;
+
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            std::array<uint32_t, 64> W; // word sequence
+            uint32_t A, B, C, D, E, F, G, H; // word buffers
+
+            std::memcpy(W.data(), blocks, 64);
+            std::transform(W.cbegin(),
+                           std::next(W.cbegin(), 16),
+                           W.begin(),
+                           [] (uint32_t n) { return htobe32(n); });
+
+            for (auto t = 16U; t < W.size(); ++t) {
+                W[t] = SIG1(W[t - 2]) + W[t - 7] + SIG0(W[t - 15]) + W[t - 16];
+            }
+
+            A = state[0];
+            B = state[1];
+            C = state[2];
+            D = state[3];
+            E = state[4];
+            F = state[5];
+            G = state[6];
+            H = state[7];
+
+            for (auto t = 0U; t < W.size(); ++t) {
+                auto T1 = H + EP1(E) + CH(E,F,G) + K[t] + W[t];
+                auto T2 = EP0(A) + MAJ(A,B,C);
+                H = G;
+                G = F;
+                F = E;
+                E = D + T1;
+                D = C;
+                C = B;
+                B = A;
+                A = T1 + T2;
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+} /* namespace legacy */
+
+#endif /* _BENCH_LEGACY_KERNELS_ */
@@ -0,0 +1,94 @@
+#ifndef _CRYPTO_ASYNC_HASH_FILE_HPP
+#define _CRYPTO_ASYNC_HASH_FILE_HPP
+
+#include "HashFile.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gsl/span>
+
+namespace crypto {
+
+    /* Tuning of hashFilesAsync().
+     **/
+    struct AsyncHashOptions
+    {
+        size_t chunkSize = 256 << 10;   // bytes per read, rounded up to a multiple of 4096
+        size_t readsPerFile = 4;        // reads in flight per file
+        size_t filesInFlight = 16;      // files open and hashed at once
+        bool useIoUring = true;         // false forces the thread pool reader
+    };
+
+    // Called with the number of bytes of file index hashed so far, size is 0 when unknown
+    using FileProgress = std::function<void(size_t index, uint64_t hashed, uint64_t size)>;
+
+    // Called once per file with its digest, only meaningful when ok
+    template <typename Hasher>
+        using FileDigest = std::function<void(size_t index, bool ok, const decltype(std::declval<Hasher&>().getHash())& digest)>;
+
+    namespace file_detail {
+        /* Reads the files of paths concurrently: calls open(index) when a file is opened, then
+         * consume(index, chunk) on its content, chunk after chunk in file order, then
+         * done(index, ok) once per file. A file stops at the first consume() returning false.
+         * At most options.filesInFlight files are between open() and done() at once; done()
+         * may come without open() for a file which was never opened.
+         *
+         * Regular files are read by a single submitting thread, the calling one, with several
+         * page-aligned reads in flight per file: through io_uring when the kernel offers it,
+         * by dedicated reader threads otherwise. Completed chunks go to tasks on pool, which
+         * call consume() (and progress()) while further reads proceed. Other files, and those
+         * whose size is not known upfront, are streamed by readFile() on pool.
+         *
+         * consume() and progress() of a given file are never called concurrently, those of
+         * different files are. open() and done() are called on the calling thread. Must not be
+         * called from a task of pool, whose workers run the hashing.
+         *
+         * When io_uring fails, the files it was reading are reported failed and the next ones
+         * are read by threads. Returns true when io_uring did all the reads.
+         **/
+        bool readFilesAsync(const std::vector<std::string>& paths,
+                            const std::function<void(size_t index)>& open,
+                            const std::function<bool(size_t index, gsl::span<const uint8_t> chunk)>& consume,
+                            const FileProgress& progress,
+                            const std::function<void(size_t index, bool ok)>& done,
+                            const AsyncHashOptions& options,
+                            ThreadPool& pool);
+
+#if defined(CRYPTO_TESTING)
+        /* Makes every io_uring_enter() of readFilesAsync() fail with error, as a broken ring
+         * would, until called with 0. Only in the builds of the tests of the library
+         * (cmake -DCRYPTO_TESTING=ON).
+         **/
+        void injectUringError(int error);
+#endif
+    } /* namespace file_detail */
+
+    /* Hashes every file of paths with its own Hasher (any of the hashing strategies, or
+     * TreeHashing), overlapping the reads of the next chunks with the hashing of the current
+     * ones and many files with each other; see file_detail::readFilesAsync().
+     *
+     * done reports each file of paths, in completion order, and progress, when given,
+     * follows each file chunk by chunk. A hasher only lives while its file is open, so that
+     * at most options.filesInFlight of them exist at once.
+     *
+     * Returns true when every file was hashed.
+     **/
+    template <typename Hasher>
+        bool hashFilesAsync(const std::vector<std::string>& paths,
+                            const FileDigest<Hasher>& done,
+                            const FileProgress& progress = nullptr,
+                            const AsyncHashOptions& options = AsyncHashOptions(),
+                            ThreadPool& pool = ThreadPool::shared());
+
+} /* namespace crypto */
+
+#include "AsyncHashFile.ipp"
+
+#endif /* _CRYPTO_ASYNC_HASH_FILE_HPP */
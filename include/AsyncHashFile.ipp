@@ -0,0 +1,55 @@
+namespace crypto {
+
+    template <typename Hasher>
+        bool hashFilesAsync(const std::vector<std::string>& paths,
+                            const FileDigest<Hasher>& done,
+                            const FileProgress& progress,
+                            const AsyncHashOptions& options,
+                            ThreadPool& pool)
+        {
+            using Digest = decltype(std::declval<Hasher&>().getHash());
+
+            // the hashers of the open files, created on the calling thread only
+            std::map<size_t, std::unique_ptr<Hasher>> hashers;
+            std::mutex mutex;
+            bool all = true;
+
+            file_detail::readFilesAsync(paths,
+                [&hashers, &mutex](size_t index) {
+                    std::unique_ptr<Hasher> hasher(new Hasher());
+                    std::lock_guard<std::mutex> lock(mutex);
+                    hashers[index] = std::move(hasher);
+                },
+                [&hashers, &mutex](size_t index, gsl::span<const uint8_t> chunk) {
+                    Hasher* hasher;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        hasher = hashers[index].get();
+                    }
+                    return hasher->update(chunk);
+                },
+                progress,
+                [&hashers, &mutex, &done, &all](size_t index, bool ok) {
+                    std::unique_ptr<Hasher> hasher;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        auto it = hashers.find(index);
+                        if (it != hashers.end()) {
+                            hasher = std::move(it->second);
+                            hashers.erase(it);
+                        }
+                    }
+
+                    Digest digest {};
+                    if (ok && hasher) {
+                        digest = hasher->getHash();
+                    }
+                    all = all && ok;
+                    done(index, ok, digest);
+                },
+                options, pool);
+
+            return all;
+        }
+
+} /* namespace crypto */
@@ -0,0 +1,135 @@
+#ifndef _CRYPTO_CHUNKER_HPP
+#define _CRYPTO_CHUNKER_HPP
+
+#include "HashingStrategy.hpp"
+#include "ThreadPool.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace crypto {
+
+    // sizes of the chunks; the average one is rounded down to a power of two (64 at least)
+    struct ChunkerOptions
+    {
+        size_t minSize = 2 * 1024;
+        size_t avgSize = 8 * 1024;
+        size_t maxSize = 64 * 1024;
+    };
+
+namespace chunk_detail {
+
+    /* Gear rolling hash with the normalized chunking of FastCDC (Xia et al., USENIX ATC
+     * 2016): no cut in the first minSize bytes of a chunk, a mask of two more bits than
+     * log2(avgSize) up to avgSize, two less after, and a forced cut at maxSize. The cut
+     * points only depend on the content, whatever the pieces it is given in.
+     **/
+    class GearScanner
+    {
+        public:
+
+            explicit GearScanner(const ChunkerOptions& options);
+
+            /* Scans from the current position of the current chunk on. Returns the number of
+             * bytes of data which belong to the chunk, the whole of size unless the chunk ends
+             * within data, in which case cut is set and the next scan starts a new chunk.
+             **/
+            size_t scan(const uint8_t* data, size_t size, bool& cut);
+
+            void reset(void);
+
+        private:
+
+            size_t m_minSize;
+            size_t m_avgSize;
+            size_t m_maxSize;
+            uint64_t m_maskS;
+            uint64_t m_maskL;
+
+            size_t m_length;    // of the current chunk so far
+            uint64_t m_fingerprint;
+    };
+
+} /* namespace chunk_detail */
+
+    /* Splits a stream into content-defined chunks and hashes each of them with Hasher
+     * (SHA256hashing, SHA1hashing, ...) in the same pass: a chunk is hashed right after it
+     * was scanned, while it is still in cache, and straight from the caller's buffer.
+     *
+     * onChunk receives every chunk in stream order, on the thread calling update() or
+     * finish(). With a pool, each chunk which starts and ends within one update() call is
+     * handed to a worker as soon as its end is found, so that the chunks are hashed while
+     * the rest of the buffer is scanned; the other chunks are hashed on the calling thread as
+     * their pieces arrive.
+     **/
+    template <typename Hasher>
+        class Chunker
+        {
+            public:
+
+                using Digest = decltype(std::declval<Hasher&>().getHash());
+
+                struct Chunk
+                {
+                    uint64_t offset;    // in the stream
+                    size_t length;
+                    Digest digest;
+                };
+
+                using ChunkCallback = std::function<void(const Chunk& chunk)>;
+
+                explicit Chunker(ChunkCallback onChunk, const ChunkerOptions& options = ChunkerOptions(), ThreadPool* pool = nullptr);
+                ~Chunker() = default;
+
+                Chunker(const Chunker& other) = delete;
+                Chunker& operator=(const Chunker& other) = delete;
+
+                bool update(gsl::span<const uint8_t> &buf);
+
+                /* Ends the stream: emits the last chunk, if any, and starts a new stream at
+                 * offset 0.
+                 **/
+                void finish(void);
+
+            private:
+
+                // a chunk held whole in the caller's buffer, hashed by a task of the pool
+                struct Piece
+                {
+                    uint64_t offset;
+                    const uint8_t* data;
+                    size_t length;
+                    Digest digest;
+                };
+
+                void emit(uint64_t offset, size_t length, const Digest& digest);
+
+                // hands the last piece to the pool
+                void submitPiece(void);
+                // waits for the pieces to be hashed and emits them
+                void emitPieces(void);
+
+                ChunkCallback m_onChunk;
+                ThreadPool* m_pool;
+                chunk_detail::GearScanner m_scanner;
+
+                // the open chunk, hashed as its pieces arrive
+                Hasher m_hasher;
+                uint64_t m_chunkOffset;
+                size_t m_chunkLength;
+
+                // the addresses of the pieces are stable while their tasks run
+                std::deque<Piece> m_pieces;
+                size_t m_pending;
+                std::mutex m_mutex;
+                std::condition_variable m_hashed;
+        };
+
+} /* namespace crypto */
+
+#include "Chunker.ipp"
+
+#endif /* _CRYPTO_CHUNKER_HPP */
@@ -0,0 +1,118 @@
+namespace crypto {
+
+    template <typename Hasher>
+        Chunker<Hasher>::Chunker(ChunkCallback onChunk, const ChunkerOptions& options, ThreadPool* pool) :
+            m_onChunk(std::move(onChunk)),
+            m_pool(pool),
+            m_scanner(options),
+            m_chunkOffset(0),
+            m_chunkLength(0),
+            m_pending(0)
+    {}
+
+    template <typename Hasher>
+        bool Chunker<Hasher>::update(gsl::span<const uint8_t> &buf)
+        {
+            if (buf.empty()) {
+                return true;
+            }
+
+            auto data = buf.data();
+            auto left = static_cast<size_t>(buf.size());
+            bool ok = true;
+
+            while (left > 0) {
+                bool cut = false;
+                auto n = m_scanner.scan(data, left, cut);
+
+                if (cut && m_chunkLength == 0 && m_pool != nullptr) {
+                    // whole in buf: hashed on the pool while the scan goes on
+                    m_pieces.push_back({ m_chunkOffset, data, n, Digest() });
+                    submitPiece();
+                } else {
+                    gsl::span<const uint8_t> piece { data, static_cast<std::ptrdiff_t>(n) };
+                    ok = m_hasher.update(piece) && ok;
+                    m_chunkLength += n;
+                    if (!cut) {
+                        break;
+                    }
+                    // the open chunk comes first in buf, before any piece
+                    emit(m_chunkOffset, m_chunkLength, m_hasher.getHash());
+                    m_chunkOffset += m_chunkLength;
+                    m_chunkLength = 0;
+                    data += n;
+                    left -= n;
+                    continue;
+                }
+
+                m_chunkOffset += n;
+                data += n;
+                left -= n;
+            }
+
+            emitPieces();
+            return ok;
+        }
+
+    template <typename Hasher>
+        void Chunker<Hasher>::finish(void)
+        {
+            if (m_chunkLength > 0) {
+                emit(m_chunkOffset, m_chunkLength, m_hasher.getHash());
+            }
+
+            m_scanner.reset();
+            m_hasher.reset();
+            m_chunkOffset = 0;
+            m_chunkLength = 0;
+        }
+
+    template <typename Hasher>
+        void Chunker<Hasher>::emit(uint64_t offset, size_t length, const Digest& digest)
+        {
+            if (m_onChunk) {
+                m_onChunk(Chunk { offset, length, digest });
+            }
+        }
+
+    template <typename Hasher>
+        void Chunker<Hasher>::submitPiece(void)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_pending;
+            }
+
+            auto piece = &m_pieces.back();
+            m_pool->submit([this, piece] {
+                Hasher hasher;
+                gsl::span<const uint8_t> bytes { piece->data, static_cast<std::ptrdiff_t>(piece->length) };
+                hasher.update(bytes);
+                piece->digest = hasher.getHash();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_pending == 0) {
+                    m_hashed.notify_all();
+                }
+            });
+        }
+
+    template <typename Hasher>
+        void Chunker<Hasher>::emitPieces(void)
+        {
+            if (m_pieces.empty()) {
+                return;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_hashed.wait(lock, [this] { return m_pending == 0; });
+            }
+
+            for (const auto& piece : m_pieces) {
+                emit(piece.offset, piece.length, piece.digest);
+            }
+            m_pieces.clear();
+        }
+
+} /* namespace crypto */
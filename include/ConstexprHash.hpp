@@ -0,0 +1,87 @@
+#ifndef _CRYPTO_CONSTEXPR_HASH_HPP
+#define _CRYPTO_CONSTEXPR_HASH_HPP
+
+#include "HashingStrategy.hpp"
+#include "MD5Constants.hpp"
+#include "SHA1Constants.hpp"
+#include "SHA256224Constants.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace crypto {
+namespace ct {
+
+    /* Digests computed in constant expressions, e.g.
+     *
+     *   constexpr auto id = crypto::ct::sha256("get-config");
+     *   static_assert(crypto::ct::prefix64(id) == 0x..., "");
+     *
+     * The results are the digests of the hashers of the same algorithm (MD5hash, SHA1hash
+     * and SHA256hash are the same CryptoHash types). The rounds and the padding are written
+     * again for C++14 constant evaluation: no std::array mutation, no lambda, no memcpy.
+     * They run at runtime too, but far slower than the hashers and the one-shot functions:
+     * they are meant for identifiers known at compile time.
+     *
+     * A string literal is hashed without its terminating null character.
+     **/
+    constexpr CryptoHash<16> md5(const char* data, size_t size);
+    constexpr CryptoHash<20> sha1(const char* data, size_t size);
+    constexpr CryptoHash<32> sha256(const char* data, size_t size);
+
+    template <size_t N>
+        constexpr CryptoHash<16> md5(const char (&literal)[N]);
+    template <size_t N>
+        constexpr CryptoHash<20> sha1(const char (&literal)[N]);
+    template <size_t N>
+        constexpr CryptoHash<32> sha256(const char (&literal)[N]);
+
+    /* First 8 bytes of a digest as a big endian integer, to switch on hashed identifiers:
+     *   case crypto::ct::prefix64(crypto::ct::sha256("get-config")):
+     **/
+    template <size_t N>
+        constexpr uint64_t prefix64(const CryptoHash<N>& digest);
+
+} /* namespace ct */
+
+namespace ct_detail {
+
+    template <size_t N_words>
+        struct State
+        {
+            uint32_t h[N_words];
+        };
+
+    /* The padded message is never materialized: byte i of it is computed from the message
+     * and its length, total being the padded length.
+     **/
+    struct Message
+    {
+        const char* data;
+        size_t size;
+        size_t total;
+        bool bigEndian;
+
+        constexpr Message(const char* d, size_t n, bool big);
+
+        constexpr uint8_t byte(size_t i) const;
+        constexpr uint32_t word(size_t i) const;    // word at byte offset i, in the algorithm's order
+    };
+
+    constexpr uint32_t rotl(uint32_t x, unsigned n);
+    constexpr uint32_t rotr(uint32_t x, unsigned n);
+
+    constexpr void md5Block(State<4>& state, const Message& msg, size_t offset);
+    constexpr void sha1Block(State<5>& state, const Message& msg, size_t offset);
+    constexpr void sha256Block(State<8>& state, const Message& msg, size_t offset);
+
+    template <bool B_bigEndian, size_t N_words, size_t... I>
+        constexpr CryptoHash<sizeof...(I)> digestOf(const State<N_words>& state, std::index_sequence<I...>);
+
+} /* namespace ct_detail */
+} /* namespace crypto */
+
+#include "ConstexprHash.ipp"
+
+#endif /* _CRYPTO_CONSTEXPR_HASH_HPP */
@@ -0,0 +1,237 @@
+namespace crypto {
+namespace ct_detail {
+
+    constexpr Message::Message(const char* d, size_t n, bool big) :
+        data(d),
+        size(n),
+        // "1" bit, then the length on 8 bytes ending a block
+        total((n + 8) / 64 * 64 + 64),
+        bigEndian(big)
+    {}
+
+    constexpr uint8_t Message::byte(size_t i) const
+    {
+        if (i < size) {
+            return static_cast<uint8_t>(data[i]);
+        }
+        if (i == size) {
+            return 0x80;
+        }
+        if (i + 8 < total) {
+            return 0;
+        }
+
+        // the length in bits, whose byte k from the end of the message is
+        const uint64_t bits = static_cast<uint64_t>(size) * 8;
+        const auto k = total - 1 - i;
+        return static_cast<uint8_t>(bigEndian ? bits >> (8 * k) : bits >> (8 * (7 - k)));
+    }
+
+    constexpr uint32_t Message::word(size_t i) const
+    {
+        uint32_t w = 0;
+        for (size_t b = 0; b < 4; ++b) {
+            const auto shift = bigEndian ? 8 * (3 - b) : 8 * b;
+            w |= static_cast<uint32_t>(byte(i + b)) << shift;
+        }
+        return w;
+    }
+
+    constexpr uint32_t rotl(uint32_t x, unsigned n)
+    {
+        return (x << n) | (x >> ((32 - n) & 31));
+    }
+
+    constexpr uint32_t rotr(uint32_t x, unsigned n)
+    {
+        return (x >> n) | (x << ((32 - n) & 31));
+    }
+
+    // as md5_detail::compress
+    constexpr void md5Block(State<4>& state, const Message& msg, size_t offset)
+    {
+        uint32_t w[16] = {};
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = msg.word(offset + 4 * t);
+        }
+
+        uint32_t a = state.h[0], b = state.h[1], c = state.h[2], d = state.h[3];
+        for (size_t t = 0; t < 64; ++t) {
+            uint32_t f = 0;
+            size_t g = 0;
+            if (t < 16) {
+                f = (b & c) | (~b & d);
+                g = t;
+            } else if (t < 32) {
+                f = (b & d) | (c & ~d);
+                g = (5 * t + 1) % 16;
+            } else if (t < 48) {
+                f = b ^ c ^ d;
+                g = (3 * t + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * t) % 16;
+            }
+
+            const auto rotated = rotl(a + f + md5_detail::K[t] + w[g], md5_detail::S[(t / 16) * 4 + (t % 4)]) + b;
+            a = d;
+            d = c;
+            c = b;
+            b = rotated;
+        }
+
+        state.h[0] += a;
+        state.h[1] += b;
+        state.h[2] += c;
+        state.h[3] += d;
+    }
+
+    // as sha1_detail::compress
+    constexpr void sha1Block(State<5>& state, const Message& msg, size_t offset)
+    {
+        uint32_t w[80] = {};
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = msg.word(offset + 4 * t);
+        }
+        for (size_t t = 16; t < 80; ++t) {
+            w[t] = rotl(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+        }
+
+        uint32_t a = state.h[0], b = state.h[1], c = state.h[2], d = state.h[3], e = state.h[4];
+        for (size_t t = 0; t < 80; ++t) {
+            uint32_t f = 0;
+            if (t < 20) {
+                f = d ^ (b & (c ^ d));
+            } else if (t < 40 || t >= 60) {
+                f = b ^ c ^ d;
+            } else {
+                f = (b & c) | (d & (b | c));
+            }
+
+            const auto temp = rotl(a, 5) + f + e + sha1_detail::K[t / 20] + w[t];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        state.h[0] += a;
+        state.h[1] += b;
+        state.h[2] += c;
+        state.h[3] += d;
+        state.h[4] += e;
+    }
+
+    // as sha256224_detail::compress
+    constexpr void sha256Block(State<8>& state, const Message& msg, size_t offset)
+    {
+        uint32_t w[64] = {};
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = msg.word(offset + 4 * t);
+        }
+        for (size_t t = 16; t < 64; ++t) {
+            const auto s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            const auto s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t v[8] = {};
+        for (size_t i = 0; i < 8; ++i) {
+            v[i] = state.h[i];
+        }
+
+        for (size_t t = 0; t < 64; ++t) {
+            const auto S1 = rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25);
+            const auto ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            const auto t1 = v[7] + S1 + ch + sha256224_detail::K[t] + w[t];
+            const auto S0 = rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22);
+            const auto maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+
+            for (size_t i = 7; i > 0; --i) {
+                v[i] = v[i - 1];
+            }
+            v[4] += t1;
+            v[0] = t1 + S0 + maj;
+        }
+
+        for (size_t i = 0; i < 8; ++i) {
+            state.h[i] += v[i];
+        }
+    }
+
+    template <bool B_bigEndian, size_t N_words, size_t... I>
+        constexpr CryptoHash<sizeof...(I)> digestOf(const State<N_words>& state, std::index_sequence<I...>)
+        {
+            return {{ static_cast<uint8_t>(state.h[I / 4] >> (B_bigEndian ? 8 * (3 - I % 4) : 8 * (I % 4)))... }};
+        }
+
+} /* namespace ct_detail */
+
+namespace ct {
+
+    constexpr CryptoHash<16> md5(const char* data, size_t size)
+    {
+        const ct_detail::Message msg(data, size, false);
+        ct_detail::State<4> state = {{ md5_detail::IV[0], md5_detail::IV[1], md5_detail::IV[2], md5_detail::IV[3] }};
+        for (size_t offset = 0; offset < msg.total; offset += 64) {
+            ct_detail::md5Block(state, msg, offset);
+        }
+        return ct_detail::digestOf<false>(state, std::make_index_sequence<16>());
+    }
+
+    constexpr CryptoHash<20> sha1(const char* data, size_t size)
+    {
+        const ct_detail::Message msg(data, size, true);
+        ct_detail::State<5> state = {{ sha1_detail::IV[0], sha1_detail::IV[1], sha1_detail::IV[2],
+                                       sha1_detail::IV[3], sha1_detail::IV[4] }};
+        for (size_t offset = 0; offset < msg.total; offset += 64) {
+            ct_detail::sha1Block(state, msg, offset);
+        }
+        return ct_detail::digestOf<true>(state, std::make_index_sequence<20>());
+    }
+
+    constexpr CryptoHash<32> sha256(const char* data, size_t size)
+    {
+        using sha256224_detail::IV256;
+
+        const ct_detail::Message msg(data, size, true);
+        ct_detail::State<8> state = {{ IV256[0], IV256[1], IV256[2], IV256[3], IV256[4], IV256[5], IV256[6], IV256[7] }};
+        for (size_t offset = 0; offset < msg.total; offset += 64) {
+            ct_detail::sha256Block(state, msg, offset);
+        }
+        return ct_detail::digestOf<true>(state, std::make_index_sequence<32>());
+    }
+
+    template <size_t N>
+        constexpr CryptoHash<16> md5(const char (&literal)[N])
+        {
+            return md5(literal, N - 1);
+        }
+
+    template <size_t N>
+        constexpr CryptoHash<20> sha1(const char (&literal)[N])
+        {
+            return sha1(literal, N - 1);
+        }
+
+    template <size_t N>
+        constexpr CryptoHash<32> sha256(const char (&literal)[N])
+        {
+            return sha256(literal, N - 1);
+        }
+
+    template <size_t N>
+        constexpr uint64_t prefix64(const CryptoHash<N>& digest)
+        {
+            static_assert(N >= 8, "digests are at least 8 bytes long");
+
+            uint64_t prefix = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                prefix = (prefix << 8) | digest[i];
+            }
+            return prefix;
+        }
+
+} /* namespace ct */
+} /* namespace crypto */
@@ -0,0 +1,110 @@
+#ifndef _CRYPTO_DIGEST_CACHE_HPP
+#define _CRYPTO_DIGEST_CACHE_HPP
+
+#include "HashFile.hpp"
+#include "HashingStrategy.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <gsl/span>
+
+namespace crypto {
+
+    // what identifies a version of a file, as given by stat()
+    struct FileKey
+    {
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        uint64_t mtimeNs;
+        uint64_t ctimeNs;
+
+        // false when path cannot be stat()ed or is not a regular file
+        static bool of(const std::string& path, FileKey& key);
+
+        bool operator==(const FileKey& other) const;
+        bool operator!=(const FileKey& other) const { return !(*this == other); }
+    };
+
+    struct DigestCacheOptions
+    {
+        // slots of a new index, rounded up to a power of two; an existing index keeps its own
+        size_t slots = 1 << 16;
+
+        /* Files changed less than this before they are hashed are not recorded: a write in
+         * the same timestamp tick as the hashing would leave the key unchanged.
+         **/
+        uint64_t racyWindowNs = 1000000000;
+    };
+
+    /* Digests of files kept across runs and processes, keyed by (device, inode, size, mtime,
+     * ctime, algorithm), so that the files unchanged since they were last hashed are not read
+     * again. The ctime can not be set back by utimes(), hence any write, truncation, rename
+     * over or metadata change of a file misses.
+     *
+     * The index is a file of fixed-size slots, an open addressing table mapped in memory and
+     * shared by all the processes which open it. Stores hold an exclusive flock() on it and
+     * mark the slot they write; lookups take no lock and run concurrently, a slot seen while
+     * it is written being a miss. Each slot also carries a checksum, so that a slot torn by a
+     * crash is just a miss. When the slots probed for a file are all taken, the first one is overwritten:
+     * the index never grows, it forgets.
+     *
+     * An index which cannot be opened or is not one leaves the cache invalid: every lookup
+     * misses, every store is dropped and hashFile() still hashes.
+     **/
+    class DigestCache
+    {
+        public:
+
+            explicit DigestCache(const std::string& indexPath, const DigestCacheOptions& options = DigestCacheOptions());
+            ~DigestCache();
+
+            DigestCache(const DigestCache& other) = delete;
+            DigestCache& operator=(const DigestCache& other) = delete;
+
+            bool valid(void) const { return m_slots != nullptr; }
+
+            /* Digest of the file at path with Hasher (any hashing strategy), read from the
+             * index when the file did not change since it was recorded, otherwise hashed and
+             * recorded. hit, when given, tells which. Returns false, leaving digest untouched,
+             * when the file cannot be read; files which are not regular are hashed but never
+             * recorded.
+             **/
+            template <typename Hasher, typename Digest = decltype(std::declval<Hasher&>().getHash())>
+                bool hashFile(const std::string& path, Digest& digest, bool* hit = nullptr);
+
+            // false on a miss, digest being left untouched; its size must be the recorded one
+            bool lookup(const FileKey& key, HashAlgorithm algorithm, gsl::span<uint8_t> digest);
+
+            /* Records the digest of a file, unless it changed too recently (see racyWindowNs).
+             * Digests are 64 bytes long at most.
+             **/
+            void store(const FileKey& key, HashAlgorithm algorithm, gsl::span<const uint8_t> digest);
+
+            // an entry of the index, laid out in DigestCache.cpp
+            struct Slot;
+
+        private:
+
+            // first slot to look at for (device, inode, algorithm)
+            size_t home(const FileKey& key, HashAlgorithm algorithm) const;
+
+            // slot holding (device, inode, algorithm), or the one to overwrite with it
+            Slot* probe(const FileKey& key, HashAlgorithm algorithm);
+
+            uint64_t m_racyWindowNs;
+            int m_fd;
+            void* m_map;
+            size_t m_mapSize;
+            Slot* m_slots;
+            size_t m_mask;
+            std::mutex m_mutex;     // of the stores
+    };
+
+} /* namespace crypto */
+
+#include "DigestCache.ipp"
+
+#endif /* _CRYPTO_DIGEST_CACHE_HPP */
@@ -0,0 +1,34 @@
+namespace crypto {
+
+    template <typename Hasher, typename Digest>
+        bool DigestCache::hashFile(const std::string& path, Digest& digest, bool* hit)
+        {
+            Hasher hasher;
+            const auto algorithm = hasher.algorithm();
+
+            FileKey before;
+            const bool regular = FileKey::of(path, before);
+            if (regular && lookup(before, algorithm, gsl::span<uint8_t>(digest.data(), static_cast<std::ptrdiff_t>(digest.size())))) {
+                if (hit != nullptr) {
+                    *hit = true;
+                }
+                return true;
+            }
+
+            if (hit != nullptr) {
+                *hit = false;
+            }
+            if (!crypto::hashFile(path, hasher)) {
+                return false;
+            }
+            digest = hasher.getHash();
+
+            // recorded only if the file did not change, or get replaced, while it was read
+            FileKey after;
+            if (regular && FileKey::of(path, after) && after == before) {
+                store(before, algorithm, gsl::span<const uint8_t>(digest.data(), static_cast<std::ptrdiff_t>(digest.size())));
+            }
+            return true;
+        }
+
+} /* namespace crypto */
@@ -0,0 +1,59 @@
+#ifndef _CRYPTO_DISPATCH_HPP
+#define _CRYPTO_DISPATCH_HPP
+
+#include "HashingStrategy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace crypto {
+namespace dispatch {
+
+    /* Block compression function of an algorithm: compresses nblocks consecutive blocks
+     * (possibly unaligned) into the chaining state, whose words are in host order.
+     **/
+    template <typename Word>
+        using BlockKernel = void (*)(Word* state, const uint8_t* blocks, size_t nblocks);
+
+    /* Every algorithm is bound to the best kernel the host supports when the library is
+     * loaded, after the CPU features are detected. The CRYPTO_KERNEL environment variable
+     * overrides that choice: a comma separated list of "<algo>=<kernel>" (for instance
+     * "SHA1=ssse3,SHA512=portable") or of bare kernel names, which apply to every algorithm
+     * having such a kernel. Entries naming an unknown or unsupported kernel are ignored.
+     *
+     * SHA-224 shares the kernels of SHA-256 and SHA-384 those of SHA-512: binding one binds
+     * the other.
+     **/
+
+    // Name of the kernel algo is bound to ("portable", "ssse3", "avx2", "shani"),
+    // nullptr for HashAlgorithm::UNKNOWN
+    const char* selected(HashAlgorithm algo);
+
+    // Names of the kernels of algo the host can run, best first
+    std::vector<std::string> available(HashAlgorithm algo);
+
+    /* Binds algo to the named kernel, or back to the best one for "auto". Returns false,
+     * leaving the binding unchanged, when the kernel is unknown or the host cannot run it.
+     * Hashers pick the new kernel up on their next block, including those in use.
+     **/
+    bool force(HashAlgorithm algo, const std::string& kernel);
+
+    /* One line summary of the detected CPU features and of the kernel of every algorithm,
+     * for instance "cpu: ssse3 sse4.1 avx2 avx512f sha; MD4=portable MD5=portable
+     * SHA1=shani SHA256=shani SHA512=avx2".
+     **/
+    std::string describe(void);
+
+    // Kernels currently bound, called by the hashers for every run of blocks
+    BlockKernel<uint32_t> md4(void);
+    BlockKernel<uint32_t> md5(void);
+    BlockKernel<uint32_t> sha1(void);
+    BlockKernel<uint32_t> sha256(void);
+    BlockKernel<uint64_t> sha512(void);
+
+} /* namespace dispatch */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_DISPATCH_HPP */
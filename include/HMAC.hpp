@@ -0,0 +1,63 @@
+#ifndef _CRYPTO_HMAC_HPP
+#define _CRYPTO_HMAC_HPP
+
+#include "HashingStrategy.hpp"
+
+#include <utility>
+
+namespace crypto {
+
+    /* HMAC (RFC 2104) over any of the hashing strategies, e.g. HMAC<SHA256hashing>.
+     *
+     * The key is absorbed once, at construction: the hash contexts after the ipad and opad
+     * blocks are kept and every MAC restarts from copies of them. A message which fits in
+     * one block with its padding then costs two compressions, one per context, and no
+     * allocation.
+     *
+     * Streaming: update() as many times as needed then getHash(), which returns the MAC and
+     * rewinds to the keyed state for the next message.
+     **/
+    template <typename Hasher>
+        class HMAC
+        {
+            public:
+
+                using Digest = decltype(std::declval<Hasher&>().getHash());
+
+                explicit HMAC(gsl::span<const uint8_t> key);
+                ~HMAC() = default;
+
+                HMAC(const HMAC& other) = delete;
+                HMAC& operator=(const HMAC& other) = delete;
+
+                HMAC(HMAC&& other) = default;
+                HMAC& operator=(HMAC&& other) = default;
+
+                bool update(gsl::span<const uint8_t> &buf);
+                Digest getHash(void);
+
+                // MAC of a whole message, any running message is discarded
+                Digest sign(gsl::span<const uint8_t> msg);
+
+                /* macs[i] receives the MAC of msgs[i], all under this key. Returns false (and
+                 * leaves macs untouched) when msgs and macs differ in size.
+                 **/
+                bool signMany(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<Digest> macs);
+
+            private:
+
+                static constexpr uint8_t IPAD = 0x36;
+                static constexpr uint8_t OPAD = 0x5c;
+
+                Hasher m_innerKeyed; // after H(K ^ ipad)
+                Hasher m_outerKeyed; // after H(K ^ opad)
+
+                Hasher m_inner;
+                Hasher m_outer;
+        };
+
+} /* namespace crypto */
+
+#include "HMAC.ipp"
+
+#endif /* _CRYPTO_HMAC_HPP */
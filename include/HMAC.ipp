@@ -0,0 +1,79 @@
+#include <algorithm>
+
+namespace crypto {
+
+    template <typename Hasher>
+        HMAC<Hasher>::HMAC(gsl::span<const uint8_t> key)
+        {
+            std::array<uint8_t, Hasher::BLOCK_SIZE> block {};
+
+            // keys longer than a block are hashed first, shorter ones are padded with 0s
+            if (static_cast<size_t>(key.size()) > block.size()) {
+                Hasher hasher;
+                hasher.update(key);
+                auto digest = hasher.getHash();
+                std::copy(digest.cbegin(), digest.cend(), block.begin());
+                std::fill(digest.begin(), digest.end(), 0);
+            } else {
+                std::copy(key.cbegin(), key.cend(), block.begin());
+            }
+
+            gsl::span<const uint8_t> pad(block);
+
+            std::transform(block.cbegin(), block.cend(), block.begin(), [](uint8_t b) { return b ^ IPAD; });
+            m_innerKeyed.update(pad);
+
+            std::transform(block.cbegin(), block.cend(), block.begin(), [](uint8_t b) { return b ^ IPAD ^ OPAD; });
+            m_outerKeyed.update(pad);
+
+            // the key must not linger on the stack
+            std::fill(block.begin(), block.end(), 0);
+
+            m_inner.copyStateFrom(m_innerKeyed);
+        }
+
+    template <typename Hasher>
+        bool HMAC<Hasher>::update(gsl::span<const uint8_t> &buf)
+        {
+            return m_inner.update(buf);
+        }
+
+    template <typename Hasher>
+        typename HMAC<Hasher>::Digest HMAC<Hasher>::getHash(void)
+        {
+            auto innerDigest = m_inner.getHash();
+            m_inner.copyStateFrom(m_innerKeyed);
+
+            gsl::span<const uint8_t> in(innerDigest);
+            m_outer.copyStateFrom(m_outerKeyed);
+            m_outer.update(in);
+
+            return m_outer.getHash();
+        }
+
+    template <typename Hasher>
+        typename HMAC<Hasher>::Digest HMAC<Hasher>::sign(gsl::span<const uint8_t> msg)
+        {
+            m_inner.copyStateFrom(m_innerKeyed);
+            if (!msg.empty()) {
+                m_inner.update(msg);
+            }
+
+            return getHash();
+        }
+
+    template <typename Hasher>
+        bool HMAC<Hasher>::signMany(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<Digest> macs)
+        {
+            if (msgs.size() != macs.size()) {
+                return false;
+            }
+
+            for (std::ptrdiff_t i = 0; i < msgs.size(); ++i) {
+                macs[i] = sign(msgs[i]);
+            }
+
+            return true;
+        }
+
+} /* namespace crypto */
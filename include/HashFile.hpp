@@ -0,0 +1,43 @@
+#ifndef _CRYPTO_HASH_FILE_HPP
+#define _CRYPTO_HASH_FILE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <gsl/span>
+
+namespace crypto {
+
+    namespace file_detail {
+        /* Calls consume() on successive non-empty pieces of the content of the file at path,
+         * in order, and stops early when it returns false.
+         *
+         * Non-empty regular files are mapped in memory (MADV_SEQUENTIAL, MADV_HUGEPAGE) and
+         * handed over in a single piece straight from the page cache. Pipes, devices and files
+         * whose size is unknown (procfs) or which cannot be mapped are read with pread(), or read() when the file is not
+         * seekable, into a page-aligned 1 MiB buffer.
+         *
+         * Returns false when the file cannot be opened or read, or when consume() does. A regular
+         * file truncated by another process while it is mapped raises SIGBUS, as with any mapping.
+         **/
+        bool readFile(const std::string& path, const std::function<bool(gsl::span<const uint8_t>)>& consume);
+    } /* namespace file_detail */
+
+    /* Feeds the content of the file at path to hasher, without getting its digest so that
+     * callers may add further data or use a hasher configured beforehand.
+     **/
+    template <typename Hasher>
+        bool hashFile(const std::string& path, Hasher& hasher);
+
+    /* Hashes the content of the file at path with Hasher (any of the hashing strategies, or
+     * TreeHashing). On failure digest is left untouched.
+     **/
+    template <typename Hasher, typename Digest = decltype(std::declval<Hasher&>().getHash())>
+        bool hashFile(const std::string& path, Digest& digest);
+
+} /* namespace crypto */
+
+#include "HashFile.ipp"
+
+#endif /* _CRYPTO_HASH_FILE_HPP */
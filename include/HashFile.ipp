@@ -0,0 +1,23 @@
+namespace crypto {
+
+    template <typename Hasher>
+        bool hashFile(const std::string& path, Hasher& hasher)
+        {
+            return file_detail::readFile(path, [&hasher](gsl::span<const uint8_t> chunk) {
+                return hasher.update(chunk);
+            });
+        }
+
+    template <typename Hasher, typename Digest>
+        bool hashFile(const std::string& path, Digest& digest)
+        {
+            Hasher hasher;
+            if (!hashFile(path, hasher)) {
+                return false;
+            }
+
+            digest = hasher.getHash();
+            return true;
+        }
+
+} /* namespace crypto */
@@ -0,0 +1,80 @@
+#ifndef _CRYPTO_HASHER_POOL_HPP
+#define _CRYPTO_HASHER_POOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace crypto {
+
+    /* Per-thread pools of ready to use hashers, e.g. HasherPool<SHA256hashing>::acquire().
+     *
+     * A lease hands out a hasher in its initial state and gives it back, reset, when it goes
+     * out of scope. Hashers are cached by the thread releasing them, without lock nor atomic
+     * operation, and a thread reuses its own ones first: once the pool of a thread holds as
+     * many hashers as it uses at once, acquiring and releasing never call the allocator.
+     * Up to MAX_IDLE hashers are kept per thread and algorithm, the surplus is freed.
+     *
+     * A lease may be released by another thread than the acquiring one, the hasher then
+     * joins the pool of the releasing thread.
+     **/
+    template <typename Hasher>
+        class HasherPool
+        {
+            public:
+
+                static constexpr size_t MAX_IDLE = 64;
+
+                class Lease
+                {
+                    public:
+
+                        Lease(Lease&& other);
+                        Lease& operator=(Lease&& other);
+                        ~Lease();
+
+                        Lease(const Lease& other) = delete;
+                        Lease& operator=(const Lease& other) = delete;
+
+                        Hasher& operator*(void) const { return *m_hasher; }
+                        Hasher* operator->(void) const { return m_hasher; }
+
+                    private:
+
+                        friend class HasherPool;
+
+                        explicit Lease(Hasher* hasher);
+
+                        Hasher* m_hasher;
+                };
+
+                HasherPool(void) = delete;
+
+                static Lease acquire(void);
+
+                // constructs hashers until the pool of the calling thread holds n (at most MAX_IDLE)
+                static void reserve(size_t n);
+
+                // number of hashers waiting in the pool of the calling thread
+                static size_t idle(void);
+
+            private:
+
+                struct Cache
+                {
+                    std::vector<Hasher*> hashers;
+
+                    Cache(void);
+                    ~Cache();
+                };
+
+                // nullptr once the thread is exiting and its cache is gone
+                static Cache* cache(void);
+
+                static void release(Hasher* hasher);
+        };
+
+} /* namespace crypto */
+
+#include "HasherPool.ipp"
+
+#endif /* _CRYPTO_HASHER_POOL_HPP */
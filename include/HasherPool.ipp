@@ -0,0 +1,116 @@
+#include <algorithm>
+
+namespace crypto {
+
+    template <typename Hasher>
+        constexpr size_t HasherPool<Hasher>::MAX_IDLE;
+
+    template <typename Hasher>
+        HasherPool<Hasher>::Lease::Lease(Hasher* hasher) :
+            m_hasher(hasher)
+    {}
+
+    template <typename Hasher>
+        HasherPool<Hasher>::Lease::Lease(Lease&& other) :
+            m_hasher(other.m_hasher)
+    {
+        other.m_hasher = nullptr;
+    }
+
+    template <typename Hasher>
+        typename HasherPool<Hasher>::Lease& HasherPool<Hasher>::Lease::operator=(Lease&& other)
+        {
+            if (this != &other) {
+                if (m_hasher != nullptr) {
+                    HasherPool::release(m_hasher);
+                }
+                m_hasher = other.m_hasher;
+                other.m_hasher = nullptr;
+            }
+            return *this;
+        }
+
+    template <typename Hasher>
+        HasherPool<Hasher>::Lease::~Lease()
+        {
+            if (m_hasher != nullptr) {
+                HasherPool::release(m_hasher);
+            }
+        }
+
+    template <typename Hasher>
+        HasherPool<Hasher>::Cache::Cache(void)
+        {
+            // releasing must never grow the vector
+            hashers.reserve(MAX_IDLE);
+        }
+
+    template <typename Hasher>
+        HasherPool<Hasher>::Cache::~Cache()
+        {
+            for (auto hasher : hashers) {
+                delete hasher;
+            }
+        }
+
+    template <typename Hasher>
+        typename HasherPool<Hasher>::Cache* HasherPool<Hasher>::cache(void)
+        {
+            // a lease may outlive the cache of its thread when both are destroyed at thread
+            // exit, the flag (trivially destructible) stays readable after the cache is gone
+            thread_local bool gone = false;
+            thread_local struct Guarded
+            {
+                Cache cache;
+                ~Guarded() { gone = true; }
+            } guarded;
+
+            return gone ? nullptr : &guarded.cache;
+        }
+
+    template <typename Hasher>
+        typename HasherPool<Hasher>::Lease HasherPool<Hasher>::acquire(void)
+        {
+            auto c = cache();
+            if (c != nullptr && !c->hashers.empty()) {
+                auto hasher = c->hashers.back();
+                c->hashers.pop_back();
+                return Lease(hasher);
+            }
+            return Lease(new Hasher());
+        }
+
+    template <typename Hasher>
+        void HasherPool<Hasher>::release(Hasher* hasher)
+        {
+            // the message may be sensitive, it does not stay in the pool
+            hasher->reset();
+
+            auto c = cache();
+            if (c != nullptr && c->hashers.size() < MAX_IDLE) {
+                c->hashers.push_back(hasher);
+            } else {
+                delete hasher;
+            }
+        }
+
+    template <typename Hasher>
+        void HasherPool<Hasher>::reserve(size_t n)
+        {
+            auto c = cache();
+            if (c == nullptr) {
+                return;
+            }
+            while (c->hashers.size() < std::min(n, MAX_IDLE)) {
+                c->hashers.push_back(new Hasher());
+            }
+        }
+
+    template <typename Hasher>
+        size_t HasherPool<Hasher>::idle(void)
+        {
+            auto c = cache();
+            return c != nullptr ? c->hashers.size() : 0;
+        }
+
+} /* namespace crypto */
@@ -5,6 +5,8 @@
 #include <array>
 #include <iostream>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <gsl/span>
 
 namespace crypto {
@@ -24,6 +26,28 @@ namespace crypto {
     template <size_t N>
         using CryptoHash = CryptoHash_uint8<N>;
 
+    /* Identifier of an algorithm in exported hash states, the values are part of the format.
+     * UNKNOWN is reported by hashing strategies defined outside the library.
+     **/
+    enum class HashAlgorithm : uint8_t
+    {
+        UNKNOWN = 0,
+        MD4 = 1,
+        MD5 = 2,
+        SHA1 = 3,
+        SHA224 = 4,
+        SHA256 = 5,
+        SHA384 = 6,
+        SHA512 = 7
+    };
+
+    /* Tag of the hasher constructor building the block cipher Cipher inside the hasher object
+     * itself rather than on the heap: constructing, moving or destroying such a hasher never
+     * calls the allocator. All the hashers of the library are built this way.
+     **/
+    template <typename Cipher>
+        struct InPlace {};
+
     template <size_t N_tmpdigest, size_t N_digest = N_tmpdigest,
               typename T_subTypeBlock = uint32_t,
               size_t N_blockSize = 16 * sizeof(T_subTypeBlock)>
@@ -31,16 +55,57 @@ namespace crypto {
         {
             public:
 
-                virtual ~HashingStrategy() = default;
+                virtual ~HashingStrategy();
 
                 bool update(gsl::span<const uint8_t> &buf);
                 CryptoHash<N_digest> getHash(void);
 
+                // drops the message hashed so far, as getHash() does
+                void reset(void);
+
+                // size of the blocks the message is compressed by (in bytes)
+                static constexpr size_t BLOCK_SIZE = N_blockSize;
+
+                virtual HashAlgorithm algorithm(void) const;
+
+                /* Overwrites the running hash with a copy of the one of other, without any
+                 * allocation. Returns false, and does nothing, when other is not of the same
+                 * class.
+                 **/
+                bool copyStateFrom(const HashingStrategy& other);
+
+                /* Checkpoint of the running hash, which can be stored and later given to
+                 * importState() of a hasher of the same algorithm to resume where it was, in
+                 * this process or another one. The format is stable, all integers are little
+                 * endian:
+                 *   4 bytes  magic "HSST"
+                 *   1 byte   format version (1)
+                 *   1 byte   algorithm (HashAlgorithm)
+                 *   2 bytes  zero
+                 *   8 bytes  length of the message hashed so far, in bytes
+                 *   N bytes  intermediate hash words (16 for MD4/MD5, 20 for SHA-1, 32 for
+                 *            SHA-224/256, 64 for SHA-384/512)
+                 *   M bytes  buffered partial block, M = message length % block size
+                 *
+                 * The checkpoint holds the tail of the message in clear, treat it as such.
+                 * Returns false for hashers which do not report their algorithm.
+                 **/
+                bool exportState(std::vector<uint8_t>& state) const;
+
+                /* Restores a checkpoint made by exportState(). Returns false, and leaves the
+                 * hasher untouched, when state is malformed or of another algorithm.
+                 **/
+                bool importState(gsl::span<const uint8_t> state);
+
             protected:
 
                 class StrategyBlockCipherLike;
 
                 HashingStrategy(std::unique_ptr<StrategyBlockCipherLike>&& p);
+
+                template <typename Cipher>
+                    HashingStrategy(InPlace<Cipher>);
+
                 HashingStrategy(void) = delete;
                 HashingStrategy(const HashingStrategy& other) = delete;
                 HashingStrategy& operator=(const HashingStrategy& other) = delete;
@@ -69,6 +134,12 @@ namespace crypto {
                         CryptoHash<N_digest> addPadding(size_t totalMsgLength);
                         virtual void reset(void) = 0;
 
+                        void copyFrom(const StrategyBlockCipherLike& other);
+
+                        // intermediate hash words in little endian followed by the buffered bytes
+                        void exportState(std::vector<uint8_t>& state) const;
+                        void importState(gsl::span<const uint8_t> state);
+
                     protected:
 
                         MsgBlock_uint8 m_msgBlock;
@@ -76,7 +147,11 @@ namespace crypto {
 
                         std::array<T_subTypeBlock, N_tmpdigest / sizeof(T_subTypeBlock)> m_intermediateHash;
 
-                        virtual void process(void) = 0;
+                        // compress the single buffered block
+                        void process(void);
+
+                        // compress nblocks consecutive full blocks read straight from blocks
+                        virtual void processBlocks(const uint8_t* blocks, size_t nblocks) = 0;
                         virtual CryptoHash<N_digest> getDigest(void) = 0;
                         virtual void setMsgSize(size_t size) = 0;
                 };
@@ -86,7 +161,24 @@ namespace crypto {
 
                 uint64_t m_msgLength; // length of the message (in bytes)
 
-                std::unique_ptr<StrategyBlockCipherLike> m_blockCipherStrategy;
+                // lives in m_inlineCipher when m_relocate is set, owned on the heap otherwise
+                StrategyBlockCipherLike* m_blockCipherStrategy;
+
+            private:
+
+                // move constructs the block cipher from into storage, whose type it knows
+                using Relocate = StrategyBlockCipherLike* (*)(void* storage, StrategyBlockCipherLike& from);
+
+                template <typename Cipher>
+                    static StrategyBlockCipherLike* relocate(void* storage, StrategyBlockCipherLike& from);
+
+                void takeCipherOf(HashingStrategy& other);
+                void destroyCipher(void);
+
+                Relocate m_relocate;
+
+                // the block ciphers of the library add no member to StrategyBlockCipherLike
+                typename std::aligned_storage<sizeof(StrategyBlockCipherLike), alignof(StrategyBlockCipherLike)>::type m_inlineCipher;
         };
 
 } /* namespace crypto */
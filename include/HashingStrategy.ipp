@@ -1,6 +1,16 @@
+#include "endian.hpp"
+#include "Padding.hpp"
+
+#if defined(CRYPTO_INSTRUMENTATION)
+#include "Instrumentation.hpp"
+#endif
+
 #include <algorithm>
 #include <type_traits>
 #include <cassert>
+#include <cstring>
+#include <new>
+#include <typeinfo>
 
 namespace crypto {
 
@@ -38,36 +48,103 @@ namespace crypto {
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::HashingStrategy(std::unique_ptr<StrategyBlockCipherLike>&& p) :
             m_msgLength(0),
-            m_blockCipherStrategy(std::move(p))
+            m_blockCipherStrategy(p.release()),
+            m_relocate(nullptr)
     {}
 
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        template <typename Cipher>
+        HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::HashingStrategy(InPlace<Cipher>) :
+            m_msgLength(0),
+            m_relocate(relocate<Cipher>)
+    {
+        static_assert(sizeof(Cipher) <= sizeof(m_inlineCipher) && alignof(Cipher) <= alignof(decltype(m_inlineCipher)),
+                      "the block cipher does not fit in the hasher");
+
+        m_blockCipherStrategy = new (&m_inlineCipher) Cipher();
+    }
+
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::HashingStrategy(HashingStrategy&& other) :
-            m_msgLength(other.m_msgLength),
-            m_blockCipherStrategy(std::move(other.m_blockCipherStrategy))
-    {}
+            m_msgLength(other.m_msgLength)
+    {
+        takeCipherOf(other);
+    }
 
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>& HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::operator=(HashingStrategy&& other)
         {
             if (this != &other) {
+                destroyCipher();
                 m_msgLength = other.m_msgLength;
-                m_blockCipherStrategy = std::move(other.m_blockCipherStrategy);
+                takeCipherOf(other);
             }
             return *this;
         }
 
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::~HashingStrategy()
+        {
+            destroyCipher();
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        template <typename Cipher>
+        typename HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike*
+        HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::relocate(void* storage, StrategyBlockCipherLike& from)
+        {
+            return new (storage) Cipher(std::move(static_cast<Cipher&>(from)));
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::takeCipherOf(HashingStrategy& other)
+        {
+            m_relocate = other.m_relocate;
+
+            if (m_relocate != nullptr) {
+                // an in place block cipher cannot change hands, it is moved into our storage
+                m_blockCipherStrategy = m_relocate(&m_inlineCipher, *other.m_blockCipherStrategy);
+            } else {
+                m_blockCipherStrategy = other.m_blockCipherStrategy;
+                other.m_blockCipherStrategy = nullptr;
+            }
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::destroyCipher(void)
+        {
+            if (m_relocate != nullptr) {
+                m_blockCipherStrategy->~StrategyBlockCipherLike();
+            } else {
+                delete m_blockCipherStrategy;
+            }
+            m_blockCipherStrategy = nullptr;
+        }
+
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         bool HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::update(gsl::span<const uint8_t> &buf)
         {
-            assert(buf.data() != nullptr && !buf.empty());
+            // an empty piece, whose data may be null, leaves the message as it is
+            if (buf.empty()) {
+                return true;
+            }
 
             if (m_msgLength + buf.size() > MAX_MSG_LENGTH) {
                 return false;
             }
 
+#if defined(CRYPTO_INSTRUMENTATION)
+            const auto start = instrumentation_detail::beginUpdate();
+            const auto before = m_msgLength;
+            uint64_t partialCopies = 0;
+#endif
+
             auto in(buf);
             while ( !in.empty() ) {
+#if defined(CRYPTO_INSTRUMENTATION)
+                // the block cipher buffers unless it is block aligned with a full block to go
+                partialCopies += (m_msgLength % N_blockSize != 0 || static_cast<size_t>(in.size()) < N_blockSize);
+#endif
                 auto written = m_blockCipherStrategy->write(in);
                 in = in.subspan(written);
 
@@ -75,12 +152,23 @@ namespace crypto {
                 m_msgLength += written;
             }
 
+#if defined(CRYPTO_INSTRUMENTATION)
+            instrumentation_detail::onUpdate(algorithm(), buf.size(), m_msgLength / N_blockSize - before / N_blockSize,
+                                             partialCopies, start);
+#endif
+
             return true;
         }
 
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         CryptoHash<N_digest> HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::getHash(void)
         {
+#if defined(CRYPTO_INSTRUMENTATION)
+            const auto start = instrumentation_detail::beginGetHash();
+            // the "1" bit and the length (two words) need a second block when they do not fit
+            const uint64_t paddingBlocks = (m_msgLength % N_blockSize + 1 + 2 * sizeof(T_subTypeBlock) > N_blockSize) ? 2 : 1;
+#endif
+
             // size of the message in bits
             CryptoHash<N_digest> digest = m_blockCipherStrategy->addPadding(m_msgLength * 8);
 
@@ -90,9 +178,100 @@ namespace crypto {
             // reset hash context
             m_msgLength = 0;
 
+#if defined(CRYPTO_INSTRUMENTATION)
+            instrumentation_detail::onGetHash(algorithm(), paddingBlocks, start);
+#endif
+
             return std::move(digest);
         }
 
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::reset(void)
+        {
+            m_blockCipherStrategy->reset();
+            m_msgLength = 0;
+        }
+
+    namespace state_detail {
+        constexpr uint8_t MAGIC[4] = { 'H', 'S', 'S', 'T' };
+        constexpr uint8_t VERSION = 1;
+        constexpr size_t HEADER_SIZE = 16;
+    } /* namespace state_detail */
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        constexpr size_t HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::BLOCK_SIZE;
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        HashAlgorithm HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::algorithm(void) const
+        {
+            return HashAlgorithm::UNKNOWN;
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        bool HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::copyStateFrom(const HashingStrategy& other)
+        {
+            // MD4 and MD5, for instance, share the same geometry but not the same rounds
+            if (typeid(*this) != typeid(other)) {
+                return false;
+            }
+
+            if (this != &other) {
+                m_msgLength = other.m_msgLength;
+                m_blockCipherStrategy->copyFrom(*other.m_blockCipherStrategy);
+            }
+            return true;
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        bool HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::exportState(std::vector<uint8_t>& state) const
+        {
+            if (algorithm() == HashAlgorithm::UNKNOWN) {
+                return false;
+            }
+
+            state.assign(state_detail::HEADER_SIZE, 0);
+            std::copy(std::begin(state_detail::MAGIC), std::end(state_detail::MAGIC), state.begin());
+            state[4] = state_detail::VERSION;
+            state[5] = static_cast<uint8_t>(algorithm());
+
+            auto length = htole64(m_msgLength);
+            std::memcpy(&state[8], &length, sizeof(length));
+
+            m_blockCipherStrategy->exportState(state);
+
+            return true;
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        bool HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::importState(gsl::span<const uint8_t> state)
+        {
+            if (algorithm() == HashAlgorithm::UNKNOWN || static_cast<size_t>(state.size()) < state_detail::HEADER_SIZE) {
+                return false;
+            }
+
+            if (!std::equal(std::begin(state_detail::MAGIC), std::end(state_detail::MAGIC), state.begin()) ||
+                    state[4] != state_detail::VERSION ||
+                    state[5] != static_cast<uint8_t>(algorithm()) ||
+                    state[6] != 0 || state[7] != 0) {
+                return false;
+            }
+
+            uint64_t length;
+            std::memcpy(&length, &state[8], sizeof(length));
+            length = le64toh(length);
+
+            // the size of the buffered block follows from the length
+            if (length > MAX_MSG_LENGTH ||
+                    static_cast<size_t>(state.size()) != state_detail::HEADER_SIZE + N_tmpdigest + length % N_blockSize) {
+                return false;
+            }
+
+            m_msgLength = length;
+            m_blockCipherStrategy->importState(state.subspan(state_detail::HEADER_SIZE));
+
+            return true;
+        }
+
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::StrategyBlockCipherLike() :
             m_spaceAvailable(m_msgBlock)
@@ -120,11 +299,55 @@ namespace crypto {
         }
 
 
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::copyFrom(const StrategyBlockCipherLike& other)
+        {
+            m_msgBlock = other.m_msgBlock;
+            m_intermediateHash = other.m_intermediateHash;
+            m_spaceAvailable = gsl::span<uint8_t>(m_msgBlock).subspan(
+                    m_msgBlock.size() - other.m_spaceAvailable.size());
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::exportState(std::vector<uint8_t>& state) const
+        {
+            for (auto word : m_intermediateHash) {
+                word = (sizeof(word) == sizeof(uint64_t)) ? htole64(word) : htole32(word);
+                auto bytes = reinterpret_cast<const uint8_t*>(&word);
+                state.insert(state.end(), bytes, bytes + sizeof(word));
+            }
+
+            auto buffered = m_msgBlock.size() - m_spaceAvailable.size();
+            state.insert(state.end(), m_msgBlock.cbegin(), std::next(m_msgBlock.cbegin(), buffered));
+        }
+
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::importState(gsl::span<const uint8_t> state)
+        {
+            for (auto& word : m_intermediateHash) {
+                std::memcpy(&word, state.data(), sizeof(word));
+                word = (sizeof(word) == sizeof(uint64_t)) ? le64toh(word) : le32toh(word);
+                state = state.subspan(sizeof(word));
+            }
+
+            m_msgBlock.fill(0);
+            std::copy(state.begin(), state.end(), m_msgBlock.begin());
+            m_spaceAvailable = gsl::span<uint8_t>(m_msgBlock).subspan(state.size());
+        }
+
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         size_t HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::write(gsl::span<const uint8_t> &buf)
         {
             assert(buf.data() != nullptr && !buf.empty());
 
+            // Nothing buffered and at least one full block available: compress the
+            // full blocks straight from the caller's buffer, only the tail is copied.
+            if (static_cast<size_t>(m_spaceAvailable.size()) == m_msgBlock.size() && static_cast<size_t>(buf.size()) >= N_blockSize) {
+                auto nblocks = static_cast<size_t>(buf.size()) / N_blockSize;
+                processBlocks(buf.data(), nblocks);
+                return nblocks * N_blockSize;
+            }
+
             auto n = std::min(m_spaceAvailable.size(), buf.size());
             std::copy_n(buf.begin(), n, m_spaceAvailable.begin());
 
@@ -138,6 +361,12 @@ namespace crypto {
             return n;
         }
 
+    template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
+        void HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::process(void)
+        {
+            processBlocks(m_msgBlock.data(), 1);
+        }
+
     template <size_t N_tmpdigest, size_t N_digest, typename T_subTypeBlock, size_t N_blockSize>
         CryptoHash<N_digest> HashingStrategy<N_tmpdigest,N_digest,T_subTypeBlock,N_blockSize>::StrategyBlockCipherLike::addPadding(size_t len)
         {
@@ -145,30 +374,14 @@ namespace crypto {
             // Given the probability of meeting a file with a size greater than 2^64-1 nowadays, and the possibilities of handling such numbers with
             // the C++ native features, we will stick for simplicity to file's effective size encoded on 64 bits.
             constexpr auto const MSG_BLOCK_SIZE = std::tuple_size<decltype(m_msgBlock)>::value;
-            constexpr auto const offset_MSGLENGTH =
-                (std::is_same<T_subTypeBlock, uint64_t>::value) ?
-                MSG_BLOCK_SIZE - sizeof(uint64_t) * 2 :
-                MSG_BLOCK_SIZE - sizeof(uint64_t);
-
-            gsl::span<uint8_t> msgBlock { m_msgBlock };
-
-            auto const it_MSGLENGTH = std::next(msgBlock.begin(), offset_MSGLENGTH);
-            auto it = std::next(msgBlock.begin(), msgBlock.size() - m_spaceAvailable.size());
-
-            // Write a "1" followed by 7 "0"s
-            *it++ = 0x80;
-
-            // Do we have the space to write the length of the message ?
-            if (std::distance(it, it_MSGLENGTH) < 0) {
-                // Pad with "0"s until the end of the block and create a new block
-                std::fill(it, msgBlock.end(), 0);
-                process();
-
-                it = msgBlock.begin();
-            }
-
-            // Pad with "0"s until the message length's offset
-            std::fill(it, it_MSGLENGTH, 0);
+            constexpr auto const MSG_LENGTH_SIZE = sizeof(T_subTypeBlock) * 2;
+
+            // Pad, in a new block when there is no space left for the length of the message
+            padding_detail::padTail<MSG_BLOCK_SIZE, MSG_LENGTH_SIZE>(
+                m_msgBlock.data(), MSG_BLOCK_SIZE - m_spaceAvailable.size(), [this](uint8_t* block) {
+                    process();
+                    return block;
+                });
 
             // Store the message length as the last 8 octets
             setMsgSize(len);
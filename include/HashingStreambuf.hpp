@@ -0,0 +1,90 @@
+#ifndef _CRYPTO_HASHING_STREAMBUF_HPP
+#define _CRYPTO_HASHING_STREAMBUF_HPP
+
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <utility>
+#include <gsl/span>
+
+namespace crypto {
+
+    /* Stream buffer hashing the data which flows through it to or from another one, e.g.
+     *
+     *   crypto::HashingStreambuf<crypto::SHA256hashing> hashing(file.rdbuf());
+     *   std::ostream out(&hashing);
+     *   out << header;
+     *   out.write(payload, size);
+     *   auto digest = hashing.getHash();
+     *
+     * Written data is gathered in a buffer of bufferSize bytes, then hashed and handed to the
+     * target in one piece. A write at least as large as the buffer skips the copy: it is
+     * hashed and passed on straight from the caller's memory. Reading works the other way
+     * round: the target is read bufferSize bytes at a time, and large reads land directly in
+     * the caller's memory. Nothing is read twice and the whole payload is never held.
+     *
+     * The digest covers the bytes written to the stream (including the ones still in the
+     * buffer, flushed first) and the ones extracted from it, not the ones read ahead from
+     * the target. Once hashed, extracted bytes can no longer be put back.
+     *
+     * Hasher is any hashing strategy, or TreeHashing. Use a buffer in one direction only,
+     * or the digest covers both directions in the order they were hashed. Seeking is not
+     * supported.
+     **/
+    template <typename Hasher>
+        class HashingStreambuf : public std::streambuf
+        {
+            public:
+
+                using Digest = decltype(std::declval<Hasher&>().getHash());
+
+                static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+                explicit HashingStreambuf(std::streambuf* target, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+                // flushes the pending output to the target, as std::filebuf does when closed
+                ~HashingStreambuf() override;
+
+                HashingStreambuf(const HashingStreambuf& other) = delete;
+                HashingStreambuf& operator=(const HashingStreambuf& other) = delete;
+
+                /* Flushes the pending output, then returns the digest of everything written or
+                 * extracted since the construction or the previous call, and starts a new
+                 * one, as the hashers do.
+                 **/
+                Digest getHash(void);
+
+                // to configure it before any data flows, or to add data which is not passed on
+                Hasher& hasher(void) { return m_hasher; }
+
+            protected:
+
+                int_type overflow(int_type ch) override;
+                std::streamsize xsputn(const char* s, std::streamsize n) override;
+                int sync(void) override;
+
+                int_type underflow(void) override;
+                std::streamsize xsgetn(char* s, std::streamsize n) override;
+
+            private:
+
+                bool hash(const char* data, size_t size);
+
+                // hands the put area over to the target, hashing what it took
+                bool flushOutput(void);
+                // hashes the bytes extracted from the get area, which then starts after them
+                bool hashExtracted(void);
+
+                std::streambuf* m_target;
+                Hasher m_hasher;
+                size_t m_bufferSize;
+                std::unique_ptr<char[]> m_putBuffer;
+                std::unique_ptr<char[]> m_getBuffer;
+                bool m_failed;      // the message outgrew the hasher
+        };
+
+} /* namespace crypto */
+
+#include "HashingStreambuf.ipp"
+
+#endif /* _CRYPTO_HASHING_STREAMBUF_HPP */
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstring>
+
+namespace crypto {
+
+    template <typename Hasher>
+        constexpr size_t HashingStreambuf<Hasher>::DEFAULT_BUFFER_SIZE;
+
+    template <typename Hasher>
+        HashingStreambuf<Hasher>::HashingStreambuf(std::streambuf* target, size_t bufferSize) :
+            m_target(target),
+            m_hasher(),
+            m_bufferSize(std::max<size_t>(bufferSize, 1)),
+            m_putBuffer(),
+            m_getBuffer(),
+            m_failed(false)
+        {}
+
+    template <typename Hasher>
+        HashingStreambuf<Hasher>::~HashingStreambuf()
+        {
+            flushOutput();
+        }
+
+    template <typename Hasher>
+        typename HashingStreambuf<Hasher>::Digest HashingStreambuf<Hasher>::getHash(void)
+        {
+            flushOutput();
+            hashExtracted();
+            m_failed = false;
+            return m_hasher.getHash();
+        }
+
+    template <typename Hasher>
+        bool HashingStreambuf<Hasher>::hash(const char* data, size_t size)
+        {
+            gsl::span<const uint8_t> bytes {reinterpret_cast<const uint8_t*>(data), static_cast<std::ptrdiff_t>(size)};
+            m_failed = m_failed || !m_hasher.update(bytes);
+            return !m_failed;
+        }
+
+    template <typename Hasher>
+        bool HashingStreambuf<Hasher>::flushOutput(void)
+        {
+            const auto pending = pptr() - pbase();
+            if (pending == 0) {
+                return !m_failed;
+            }
+
+            const auto written = m_target->sputn(pbase(), pending);
+            const bool hashed = hash(pbase(), static_cast<size_t>(std::max<std::streamsize>(written, 0)));
+            setp(m_putBuffer.get(), m_putBuffer.get() + m_bufferSize);
+            return hashed && written == pending;
+        }
+
+    template <typename Hasher>
+        bool HashingStreambuf<Hasher>::hashExtracted(void)
+        {
+            if (eback() == gptr()) {
+                return !m_failed;
+            }
+
+            const bool hashed = hash(eback(), static_cast<size_t>(gptr() - eback()));
+            setg(gptr(), gptr(), egptr());
+            return hashed;
+        }
+
+    template <typename Hasher>
+        typename HashingStreambuf<Hasher>::int_type HashingStreambuf<Hasher>::overflow(int_type ch)
+        {
+            if (!m_putBuffer) {
+                m_putBuffer.reset(new char[m_bufferSize]);
+                setp(m_putBuffer.get(), m_putBuffer.get() + m_bufferSize);
+            } else if (!flushOutput()) {
+                return traits_type::eof();
+            }
+
+            if (traits_type::eq_int_type(ch, traits_type::eof())) {
+                return traits_type::not_eof(ch);
+            }
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+            return ch;
+        }
+
+    template <typename Hasher>
+        std::streamsize HashingStreambuf<Hasher>::xsputn(const char* s, std::streamsize n)
+        {
+            // what fits is gathered, the rest of a small write goes to a flushed buffer
+            if (n < epptr() - pptr()) {
+                std::memcpy(pptr(), s, static_cast<size_t>(n));
+                pbump(static_cast<int>(n));
+                return n;
+            }
+            if (n < static_cast<std::streamsize>(m_bufferSize)) {
+                if (traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+                    return 0;
+                }
+                std::memcpy(pptr(), s, static_cast<size_t>(n));
+                pbump(static_cast<int>(n));
+                return n;
+            }
+
+            // large writes go through as they are, after what precedes them
+            if (!flushOutput()) {
+                return 0;
+            }
+            const auto written = m_target->sputn(s, n);
+            if (!hash(s, static_cast<size_t>(std::max<std::streamsize>(written, 0)))) {
+                return 0;
+            }
+            return written;
+        }
+
+    template <typename Hasher>
+        int HashingStreambuf<Hasher>::sync(void)
+        {
+            if (!flushOutput()) {
+                return -1;
+            }
+            return m_target->pubsync();
+        }
+
+    template <typename Hasher>
+        typename HashingStreambuf<Hasher>::int_type HashingStreambuf<Hasher>::underflow(void)
+        {
+            if (gptr() < egptr()) {
+                return traits_type::to_int_type(*gptr());
+            }
+            if (!hashExtracted()) {
+                return traits_type::eof();
+            }
+
+            if (!m_getBuffer) {
+                m_getBuffer.reset(new char[m_bufferSize]);
+            }
+            const auto got = m_target->sgetn(m_getBuffer.get(), static_cast<std::streamsize>(m_bufferSize));
+            if (got <= 0) {
+                setg(m_getBuffer.get(), m_getBuffer.get(), m_getBuffer.get());
+                return traits_type::eof();
+            }
+            setg(m_getBuffer.get(), m_getBuffer.get(), m_getBuffer.get() + got);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    template <typename Hasher>
+        std::streamsize HashingStreambuf<Hasher>::xsgetn(char* s, std::streamsize n)
+        {
+            std::streamsize done = 0;
+            while (done < n) {
+                const auto available = egptr() - gptr();
+                if (available > 0) {
+                    const auto count = std::min<std::streamsize>(available, n - done);
+                    std::memcpy(s + done, gptr(), static_cast<size_t>(count));
+                    gbump(static_cast<int>(count));
+                    done += count;
+                    continue;
+                }
+
+                // large reads land in the caller's memory and are hashed there
+                if (n - done >= static_cast<std::streamsize>(m_bufferSize)) {
+                    if (!hashExtracted()) {
+                        break;
+                    }
+                    const auto got = m_target->sgetn(s + done, n - done);
+                    if (got <= 0 || !hash(s + done, static_cast<size_t>(got))) {
+                        break;
+                    }
+                    done += got;
+                    continue;
+                }
+
+                if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                    break;
+                }
+            }
+            return done;
+        }
+
+} /* namespace crypto */
@@ -0,0 +1,71 @@
+#ifndef _CRYPTO_HEX_HPP
+#define _CRYPTO_HEX_HPP
+
+#include "HashingStrategy.hpp"
+
+namespace crypto {
+
+    /* Lower case hexadecimal text of bytes, written to out which must hold 2 * bytes.size()
+     * characters (no terminating null is written).
+     *
+     * Unlike operator<<, no stream and no allocation are involved; 32 bytes are
+     * encoded at once with AVX2 table lookups, then 16 with SSSE3 ones, when the host has
+     * them, so that the digests shorter than 32 bytes are vectorized as well.
+     **/
+    void toHex(gsl::span<const uint8_t> bytes, char* out);
+
+    /* Decodes the hexadecimal text, in any case, to out which must hold text.size() / 2
+     * bytes. Returns false when text has an odd length or any character which is not an
+     * hexadecimal digit, the content of out is then unspecified.
+     **/
+    bool fromHex(gsl::span<const char> text, uint8_t* out);
+
+    /* Whether a and b hold the same bytes, in a time which only depends on their sizes, to
+     * check a MAC or a digest against an expected one without leaking how much of it
+     * matched. Spans of different sizes are unequal.
+     **/
+    bool equals(gsl::span<const uint8_t> a, gsl::span<const uint8_t> b);
+
+    // text of a digest, e.g. toHex(hasher.getHash()).data()
+    template <size_t N>
+        std::array<char, 2 * N + 1> toHex(const CryptoHash<N>& digest);
+
+    // false, leaving digest untouched, unless text is the 2 * N digits of a digest
+    template <size_t N>
+        bool fromHex(gsl::span<const char> text, CryptoHash<N>& digest);
+
+    template <size_t N>
+        bool equals(const CryptoHash<N>& a, const CryptoHash<N>& b);
+
+namespace hex_detail {
+
+    // kernels over whole vectors: n is a multiple of 16 (SSSE3) or 32 (AVX2) input bytes
+    bool hasSSSE3(void);
+    void encodeSSSE3(const uint8_t* in, size_t n, char* out);
+    bool decodeSSSE3(const char* in, size_t n, uint8_t* out);
+
+    bool hasAVX2(void);
+    void encodeAVX2(const uint8_t* in, size_t n, char* out);
+    bool decodeAVX2(const char* in, size_t n, uint8_t* out);
+
+    // portable versions, for any n
+    void encode(const uint8_t* in, size_t n, char* out);
+    bool decode(const char* in, size_t n, uint8_t* out);
+
+    enum class Kernel { PORTABLE, SSSE3, AVX2 };
+
+    // the widest kernel of the host, the one toHex() and fromHex() start with
+    Kernel widest(void);
+
+    /* Any n, with the kernels up to widest: the whole vectors of the widest, then the
+     * vector of a narrower one which is left, then the portable code.
+     **/
+    void encode(Kernel widest, const uint8_t* in, size_t n, char* out);
+    bool decode(Kernel widest, const char* in, size_t n, uint8_t* out);
+
+} /* namespace hex_detail */
+} /* namespace crypto */
+
+#include "Hex.ipp"
+
+#endif /* _CRYPTO_HEX_HPP */
@@ -0,0 +1,29 @@
+namespace crypto {
+
+    template <size_t N>
+        std::array<char, 2 * N + 1> toHex(const CryptoHash<N>& digest)
+        {
+            std::array<char, 2 * N + 1> text;
+            toHex(digest, text.data());
+            text[2 * N] = '\0';
+            return text;
+        }
+
+    template <size_t N>
+        bool fromHex(gsl::span<const char> text, CryptoHash<N>& digest)
+        {
+            CryptoHash<N> decoded;
+            if (text.size() != static_cast<std::ptrdiff_t>(2 * N) || !fromHex(text, decoded.data())) {
+                return false;
+            }
+            digest = decoded;
+            return true;
+        }
+
+    template <size_t N>
+        bool equals(const CryptoHash<N>& a, const CryptoHash<N>& b)
+        {
+            return equals(gsl::span<const uint8_t>(a), gsl::span<const uint8_t>(b));
+        }
+
+} /* namespace crypto */
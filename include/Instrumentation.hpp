@@ -0,0 +1,96 @@
+#ifndef _CRYPTO_INSTRUMENTATION_HPP
+#define _CRYPTO_INSTRUMENTATION_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace crypto {
+
+    // defined in HashingStrategy.hpp, which includes this header when instrumented
+    enum class HashAlgorithm : uint8_t;
+
+namespace instrumentation {
+
+    /* Usage statistics of the hashers built on HashingStrategy, per algorithm.
+     *
+     * Off unless the library and its users are all built with CRYPTO_INSTRUMENTATION
+     * defined (cmake -DCRYPTO_INSTRUMENTATION=ON): the hooks are then compiled out of the hot
+     * path entirely and snapshot() reports nothing. When on, every thread counts in its own
+     * block of statistics with relaxed stores only, and snapshot() adds up all of them,
+     * including the ones of the threads which exited since.
+     *
+     * Reading the clock costs more than hashing a short message, so the latencies are only
+     * measured for one call in LATENCY_SAMPLING of each thread; the counters are exact.
+     *
+     * The one-shot functions, the multi-buffer engines and the other paths running the
+     * kernels without a hasher object are not counted.
+     **/
+#if defined(CRYPTO_INSTRUMENTATION)
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    constexpr unsigned LATENCY_SAMPLING = 16;
+
+    /* Latency distribution in nanoseconds, in log-linear buckets as HdrHistogram does: exact
+     * below 8 ns, then 8 buckets per power of two, i.e. within 12.5% of the recorded values.
+     **/
+    struct HistogramSnapshot
+    {
+        uint64_t count;
+        uint64_t sum;
+        uint64_t max;
+
+        // (lowest value of the bucket, number of values in it) of the non-empty buckets, by value
+        std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+        // lowest value of the bucket holding the q quantile (q in [0, 1]), 0 when empty
+        uint64_t percentile(double q) const;
+    };
+
+    struct AlgorithmSnapshot
+    {
+        HashAlgorithm algorithm;
+
+        uint64_t bytes;             // bytes given to update()
+        uint64_t blocks;            // blocks compressed, padding blocks included
+        uint64_t partialCopies;     // pieces of input copied to the partial block buffer
+        uint64_t updates;
+        uint64_t getHashes;
+
+        HistogramSnapshot updateLatency;
+        HistogramSnapshot getHashLatency;
+    };
+
+    struct Snapshot
+    {
+        // the algorithms with any activity, in HashAlgorithm order
+        std::vector<AlgorithmSnapshot> algorithms;
+
+        // nullptr when algorithm did not hash anything
+        const AlgorithmSnapshot* find(HashAlgorithm algorithm) const;
+    };
+
+    Snapshot snapshot(void);
+
+    /* Zeroes the statistics of all threads. Counts made while it runs may be lost.
+     **/
+    void reset(void);
+
+} /* namespace instrumentation */
+
+namespace instrumentation_detail {
+
+    // start time of a call whose latency is sampled, in nanoseconds, 0 for the other calls
+    uint64_t beginUpdate(void);
+    uint64_t beginGetHash(void);
+
+    void onUpdate(HashAlgorithm algorithm, uint64_t bytes, uint64_t blocks, uint64_t partialCopies, uint64_t start);
+    void onGetHash(HashAlgorithm algorithm, uint64_t blocks, uint64_t start);
+
+} /* namespace instrumentation_detail */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_INSTRUMENTATION_HPP */
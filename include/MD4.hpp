@@ -22,6 +22,11 @@ namespace crypto {
             MD4hashing(MD4hashing&& other) = default;
             MD4hashing& operator=(MD4hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            MD4hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             using HS = HashingStrategy<MD4_HASH_SIZE>;
@@ -30,7 +35,7 @@ namespace crypto {
             class MD4BlockCipherLike final : public StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override;
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override;
                     virtual MD4hash getDigest(void) final override;
                     virtual void setMsgSize(size_t size) final override;
 
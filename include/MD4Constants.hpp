@@ -0,0 +1,31 @@
+#ifndef _MD4_CONSTANTS_
+#define _MD4_CONSTANTS_
+
+#include <array>
+#include <cstdint>
+
+namespace crypto {
+namespace md4_detail {
+
+    // initial hash value (RFC 1320, 3.3)
+    constexpr std::array<uint32_t, 4> IV = {{
+        0x67452301,
+        0xEFCDAB89,
+        0x98BADCFE,
+        0x10325476
+    }};
+
+    // additive constant of each round (RFC 1320, 3.4)
+    constexpr std::array<uint32_t, 3> K = {{ 0, 0x5a827999, 0x6ed9eba1 }};
+
+    // per-round shift amounts, 4 per round (RFC 1320, 3.4)
+    constexpr std::array<uint8_t, 12> S = {{
+        3, 7, 11, 19,
+        3, 5,  9, 13,
+        3, 9, 11, 15
+    }};
+
+} /* namespace md4_detail */
+} /* namespace crypto */
+
+#endif /* _MD4_CONSTANTS_ */
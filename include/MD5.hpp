@@ -22,6 +22,11 @@ namespace crypto {
             MD5hashing(MD5hashing&& other) = default;
             MD5hashing& operator=(MD5hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            MD5hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             using HS = HashingStrategy<MD5_HASH_SIZE>;
@@ -30,7 +35,7 @@ namespace crypto {
             class MD5BlockCipherLike final : public StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override;
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override;
                     virtual MD5hash getDigest(void) final override;
                     virtual void setMsgSize(size_t size) final override;
 
@@ -0,0 +1,101 @@
+#ifndef _MD5_KERNEL_
+#define _MD5_KERNEL_
+
+#include "MD5Constants.hpp"
+#include "utils.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace crypto {
+namespace md5_detail {
+
+    /* Compresses nblocks consecutive 64 bytes blocks (possibly unaligned) into state.
+     **/
+    inline void compress(std::array<uint32_t, 4>& state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        using utils::rotate_left;
+
+        auto F = [](auto x, auto y, auto z) { return (x & y) | ((~x) & z); };
+        auto G = [](auto x, auto y, auto z) { return (x & z) | (y & (~z)); };
+        auto H = [](auto x, auto y, auto z) { return x ^ y ^ z; };
+        auto I = [](auto x, auto y, auto z) { return y ^ (x | (~z)); };
+
+        auto f = [](auto x) { return x % 16; };
+        auto g = [](auto x) { return (5 * x + 1) % 16; };
+        auto h = [](auto x) { return (3 * x + 5) % 16; };
+        auto i = [](auto x) { return (7 * x) % 16; };
+
+        auto XX = [](auto X, auto &a, auto b, auto c, auto d, auto k, auto w, auto s)
+        {
+            a += X(b,c,d) + k + w;
+            a = rotate_left(a,s);
+            a += b;
+        };
+
+        auto shift = [](auto x) { return (x / 16) * 4 + (x % 4); };
+
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            std::array<uint32_t, 16> W;
+            uint32_t A, B, C, D;
+
+            // initialize the 16 words in the array W (the block may be unaligned)
+            std::memcpy(W.data(), blocks, sizeof(W));
+            std::transform(W.begin(),
+                           W.end(),
+                           W.begin(),
+                           [](uint32_t n) { return htole32(n); });
+
+            A = state[0];
+            B = state[1];
+            C = state[2];
+            D = state[3];
+
+            for (uint8_t t = 0; t < 16; ++t) {
+                XX( F, A, B, C, D, K[t], W[ f(t) ], S[ shift(t) ] );
+                auto temp = D;
+                D = C;
+                C = B;
+                B = A;
+                A = temp;
+            }
+
+            for (uint8_t t = 16; t < 32; ++t) {
+                XX( G, A, B, C, D, K[t], W[ g(t) ], S[ shift(t) ] );
+                auto temp = D;
+                D = C;
+                C = B;
+                B = A;
+                A = temp;
+            }
+
+            for (uint8_t t = 32; t < 48; ++t) {
+                XX( H, A, B, C, D, K[t], W[ h(t) ], S[ shift(t) ] );
+                auto temp = D;
+                D = C;
+                C = B;
+                B = A;
+                A = temp;
+            }
+
+            for (uint8_t t = 48; t < 64; ++t) {
+                XX( I, A, B, C, D, K[t], W[ i(t) ], S[ shift(t) ] );
+                auto temp = D;
+                D = C;
+                C = B;
+                B = A;
+                A = temp;
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+        }
+    }
+
+} /* namespace md5_detail */
+} /* namespace crypto */
+
+#endif /* _MD5_KERNEL_ */
@@ -0,0 +1,72 @@
+#ifndef _CRYPTO_MULTIBUFFER_HPP
+#define _CRYPTO_MULTIBUFFER_HPP
+
+#include "HashingStrategy.hpp"
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA256.hpp"
+#include "SHA512.hpp"
+#include "ThreadPool.hpp"
+
+#include <utility>
+
+namespace crypto {
+namespace multibuffer {
+
+    template <typename Hasher>
+        using Digest = decltype(std::declval<Hasher&>().getHash());
+
+    /* Hashes every message of msgs independently: digests[i] receives the digest of msgs[i].
+     *
+     * The messages are spread over the SIMD lanes of the widest engine the host supports
+     * (4, 8 or 16 lanes for MD5, SHA-1 and SHA-256, 2, 4 or 8 lanes for SHA-512) and all
+     * lanes are compressed together. A lane is refilled with the next pending message as
+     * soon as its own one is padded and compressed, so messages may have any length.
+     *
+     * Returns false (and leaves digests untouched) when msgs and digests differ in size.
+     * Only MD5hashing, SHA1hashing, SHA256hashing and SHA512hashing are supported.
+     **/
+    template <typename Hasher>
+        bool hashMany(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<Digest<Hasher>> digests);
+
+    /* Hashes count records of length bytes laid out stride bytes apart from base, as the
+     * rows of a table of fixed width keys: digests[i] receives the digest of the length bytes
+     * at base + i * stride.
+     *
+     * As every record has the same length, the padded tail blocks are built once: only the
+     * words which hold record bytes are filled per record, the padding and length words are
+     * shared by all of them. The records are spread over the SIMD lanes as by hashMany(),
+     * in lockstep since they all take the same number of blocks, and runs of records are
+     * handed to the workers of pool when there are enough of them.
+     *
+     * Returns false (and leaves digests untouched) when digests does not hold count digests.
+     * Only MD5hashing, SHA1hashing, SHA256hashing and SHA512hashing are supported.
+     **/
+    template <typename Hasher>
+        bool hashRecords(const uint8_t* base, size_t stride, size_t length, size_t count,
+                         gsl::span<Digest<Hasher>> digests, ThreadPool& pool = ThreadPool::shared());
+
+    /* Number of messages hashMany<Hasher> processes side by side on this host.
+     **/
+    template <typename Hasher>
+        size_t lanes(void);
+
+    template <> bool hashMany<MD5hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<MD5hash> digests);
+    template <> bool hashMany<SHA1hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA1hash> digests);
+    template <> bool hashMany<SHA256hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA256hash> digests);
+    template <> bool hashMany<SHA512hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA512hash> digests);
+
+    template <> bool hashRecords<MD5hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<MD5hash> digests, ThreadPool& pool);
+    template <> bool hashRecords<SHA1hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA1hash> digests, ThreadPool& pool);
+    template <> bool hashRecords<SHA256hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA256hash> digests, ThreadPool& pool);
+    template <> bool hashRecords<SHA512hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA512hash> digests, ThreadPool& pool);
+
+    template <> size_t lanes<MD5hashing>(void);
+    template <> size_t lanes<SHA1hashing>(void);
+    template <> size_t lanes<SHA256hashing>(void);
+    template <> size_t lanes<SHA512hashing>(void);
+
+} /* namespace multibuffer */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_MULTIBUFFER_HPP */
@@ -0,0 +1,110 @@
+#ifndef _CRYPTO_MULTI_DIGEST_HPP
+#define _CRYPTO_MULTI_DIGEST_HPP
+
+#include "MD4.hpp"
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA224.hpp"
+#include "SHA256.hpp"
+#include "SHA384.hpp"
+#include "SHA512.hpp"
+#include "ThreadPool.hpp"
+
+#include <initializer_list>
+
+namespace crypto {
+
+    /* Digests of one message under several algorithms, computed in a single pass over it,
+     * e.g. MultiDigest({ HashAlgorithm::MD5, HashAlgorithm::SHA1, HashAlgorithm::SHA256 }).
+     *
+     * update() cuts its input into slices small enough to stay in L1 and hands each slice to
+     * every algorithm in turn before moving to the next one, so the message is read from
+     * memory once whatever the number of algorithms. The full blocks of a slice are
+     * compressed straight from the caller's buffer, only the block straddling two slices is
+     * copied.
+     *
+     * Given a pool, large inputs are instead cut into L2 sized windows whose algorithms run on
+     * the workers side by side; every window is done by all of them before the next one
+     * starts, so they still share its cache lines instead of streaming the input apart.
+     *
+     * Hashers are held inline: without a pool, nothing is allocated. With one, each window
+     * goes through ThreadPool::parallelFor(), which allocates its shared batch and the tasks
+     * of the workers: a few allocations per 256 KiB window.
+     **/
+    class MultiDigest
+    {
+        public:
+
+            // digests of the algorithms hashed, the other ones are left zeroed
+            struct Digests
+            {
+                MD4hash md4;
+                MD5hash md5;
+                SHA1hash sha1;
+                SHA224hash sha224;
+                SHA256hash sha256;
+                SHA384hash sha384;
+                SHA512hash sha512;
+
+                // bytes of the digest of algorithm, empty for UNKNOWN
+                gsl::span<const uint8_t> operator[](HashAlgorithm algorithm) const;
+            };
+
+            // bytes of input, per update() call, below which the pool is not used
+            static constexpr size_t PARALLEL_THRESHOLD = 256 * 1024;
+
+            explicit MultiDigest(std::initializer_list<HashAlgorithm> algorithms, ThreadPool* pool = nullptr);
+            explicit MultiDigest(const std::vector<HashAlgorithm>& algorithms, ThreadPool* pool = nullptr);
+            ~MultiDigest() = default;
+
+            MultiDigest(const MultiDigest& other) = delete;
+            MultiDigest& operator=(const MultiDigest& other) = delete;
+
+            MultiDigest(MultiDigest&& other) = default;
+            MultiDigest& operator=(MultiDigest&& other) = default;
+
+            bool update(gsl::span<const uint8_t> &buf);
+
+            // digests of the message hashed so far, which is dropped as by a hasher's getHash()
+            Digests getHashes(void);
+
+            void reset(void);
+
+            bool has(HashAlgorithm algorithm) const;
+
+            // the algorithms hashed, in HashAlgorithm order and without duplicates
+            std::vector<HashAlgorithm> algorithms(void) const;
+
+        private:
+
+            // number of algorithms of HashAlgorithm, UNKNOWN included
+            static constexpr size_t ALGORITHMS = static_cast<size_t>(HashAlgorithm::SHA512) + 1;
+
+            // L1 sized, and a multiple of every block size so slices stay block aligned
+            static constexpr size_t SLICE_SIZE = 16 * 1024;
+            // L2 sized, per pool window
+            static constexpr size_t WINDOW_SIZE = 256 * 1024;
+
+            void enable(HashAlgorithm algorithm);
+
+            // feeds the whole of piece to algorithm, slice by slice
+            void updateOne(HashAlgorithm algorithm, gsl::span<const uint8_t> piece);
+
+            MD4hashing m_md4;
+            MD5hashing m_md5;
+            SHA1hashing m_sha1;
+            SHA224hashing m_sha224;
+            SHA256hashing m_sha256;
+            SHA384hashing m_sha384;
+            SHA512hashing m_sha512;
+
+            // bit i set when HashAlgorithm i is hashed
+            uint32_t m_enabled;
+
+            uint64_t m_msgLength;
+            ThreadPool* m_pool;
+    };
+
+} /* namespace crypto */
+
+#endif /* _CRYPTO_MULTI_DIGEST_HPP */
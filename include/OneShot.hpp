@@ -0,0 +1,31 @@
+#ifndef _CRYPTO_ONE_SHOT_HPP
+#define _CRYPTO_ONE_SHOT_HPP
+
+#include "MD4.hpp"
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA224.hpp"
+#include "SHA256.hpp"
+#include "SHA384.hpp"
+#include "SHA512.hpp"
+
+namespace crypto {
+
+    /* Digest of a whole message held in memory, e.g. crypto::sha256(key).
+     *
+     * The full blocks are compressed straight from msg by the kernel the dispatcher bound
+     * to the algorithm, the tail is padded in a block on the stack: no hasher object, no
+     * buffering and no allocation. The empty message is a valid input. The digests are
+     * the ones of the hashers of the same algorithm.
+     **/
+    MD4hash md4(gsl::span<const uint8_t> msg);
+    MD5hash md5(gsl::span<const uint8_t> msg);
+    SHA1hash sha1(gsl::span<const uint8_t> msg);
+    SHA224hash sha224(gsl::span<const uint8_t> msg);
+    SHA256hash sha256(gsl::span<const uint8_t> msg);
+    SHA384hash sha384(gsl::span<const uint8_t> msg);
+    SHA512hash sha512(gsl::span<const uint8_t> msg);
+
+} /* namespace crypto */
+
+#endif /* _CRYPTO_ONE_SHOT_HPP */
@@ -0,0 +1,57 @@
+#ifndef _CRYPTO_PADDING_HPP
+#define _CRYPTO_PADDING_HPP
+
+#include "endian.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace crypto {
+namespace padding_detail {
+
+    /* Merkle–Damgård padding of the last fill bytes of a message, held at the start of block
+     * (N_block bytes): a "1" followed by 7 "0"s, then "0"s up to the end of the block, over
+     * the N_length bytes of the message length field as well. When that field does not fit
+     * after the marker, next(block) is given the block completed with "0"s and returns the
+     * one which goes on with the padding: the same one once compressed, or the one after it.
+     *
+     * Returns the block ending with the length field, for the caller to write it.
+     **/
+    template <size_t N_block, size_t N_length, typename Next>
+        inline uint8_t* padTail(uint8_t* block, size_t fill, Next next)
+        {
+            block[fill++] = 0x80;
+            if (fill > N_block - N_length) {
+                std::memset(block + fill, 0, N_block - fill);
+                block = next(block);
+                fill = 0;
+            }
+            std::memset(block + fill, 0, N_block - fill);
+            return block;
+        }
+
+    /* Same, then writes the size of the message, in bits, on the last 64 bits of the length
+     * field in the byte order of the algorithm (the upper half of the 128 bits field of
+     * SHA-384/512 stays zero).
+     **/
+    template <size_t N_block, size_t N_length, bool B_bigEndian, typename Next>
+        inline uint8_t* padTail(uint8_t* block, size_t fill, uint64_t msgLength, Next next)
+        {
+            block = padTail<N_block, N_length>(block, fill, next);
+            const uint64_t bits = B_bigEndian ? htobe64(msgLength * 8) : htole64(msgLength * 8);
+            std::memcpy(block + N_block - sizeof(bits), &bits, sizeof(bits));
+            return block;
+        }
+
+    // next block of padTail() for a buffer of two consecutive blocks, compressed at once
+    template <size_t N_block>
+        inline uint8_t* followingBlock(uint8_t* block)
+        {
+            return block + N_block;
+        }
+
+} /* namespace padding_detail */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_PADDING_HPP */
@@ -9,6 +9,19 @@ namespace crypto {
 
     using SHA1hash = CryptoHash<SHA1_HASH_SIZE>;
 
+    namespace sha1_detail {
+        // x86 SHA extensions kernel (src/SHA1_SHANI.cpp), only valid when hasSHANI() is true
+        bool hasSHANI(void);
+        void processBlocksSHANI(uint32_t* state, const uint8_t* blocks, size_t nblocks);
+
+        // vectorized message expansion (src/SHA1_SSSE3.cpp, src/SHA1_AVX2.cpp): wk receives
+        // W[t] + K[t / 20] for the 80 rounds of a block, only valid when hasX() is true
+        bool hasSSSE3(void);
+        void expandSSSE3(const uint8_t* block, uint32_t* wk);
+        bool hasAVX2(void);
+        void expandAVX2(const uint8_t* twoBlocks, uint32_t* wk0, uint32_t* wk1);
+    } /* namespace sha1_detail */
+
     class SHA1hashing final : public HashingStrategy<SHA1_HASH_SIZE>
     {
         public:
@@ -22,6 +35,11 @@ namespace crypto {
             SHA1hashing(SHA1hashing&& other) = default;
             SHA1hashing& operator=(SHA1hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            SHA1hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             using HS = HashingStrategy<SHA1_HASH_SIZE>;
@@ -30,7 +48,7 @@ namespace crypto {
             class SHA1BlockCipherLike final : public StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override;
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override;
                     virtual SHA1hash getDigest(void) final override;
                     virtual void setMsgSize(size_t size) final override;
 
@@ -0,0 +1,30 @@
+#ifndef _SHA1_CONSTANTS_
+#define _SHA1_CONSTANTS_
+
+#include <array>
+#include <cstdint>
+
+namespace crypto {
+namespace sha1_detail {
+
+    // initial hash value (FIPS 180-4, 5.3.1)
+    constexpr std::array<uint32_t, 5> IV = {{
+        0x67452301,
+        0xEFCDAB89,
+        0x98BADCFE,
+        0x10325476,
+        0xC3D2E1F0
+    }};
+
+    // one constant per group of 20 rounds (FIPS 180-4, 4.2.1)
+    constexpr std::array<uint32_t, 4> K = {{
+        0x5A827999,
+        0x6ED9EBA1,
+        0x8F1BBCDC,
+        0xCA62C1D6
+    }};
+
+} /* namespace sha1_detail */
+} /* namespace crypto */
+
+#endif /* _SHA1_CONSTANTS_ */
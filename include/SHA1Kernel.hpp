@@ -0,0 +1,361 @@
+#ifndef _SHA1_KERNEL_
+#define _SHA1_KERNEL_
+
+#include "SHA1Constants.hpp"
+#include "endian.hpp"
+
+#include <cstring>
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace sha1_detail {
+
+    // Rotation by a constant amount, which compilers turn into a single rotate instruction
+    inline uint32_t rotl(uint32_t x, unsigned int n) noexcept
+    {
+#if defined(__clang__)
+        return __builtin_rotateleft32(x, n);
+#else
+        return (x << n) | (x >> (32 - n));
+#endif
+    }
+
+    /* Round T on the working variables as named at round T; the caller shifts the names by
+     * one for round T + 1 instead of moving the values: only b and e are written. The round
+     * function is selected at compile time, w(T) gives W[T] + K[T / 20].
+     **/
+    template <unsigned int T, typename Schedule>
+        inline void round(uint32_t a, uint32_t& b, uint32_t c, uint32_t d, uint32_t& e, Schedule& w) noexcept
+        {
+            uint32_t f;
+            if (T < 20) {
+                f = d ^ (b & (c ^ d));              // choose
+            } else if (T < 40 || T >= 60) {
+                f = b ^ c ^ d;                      // parity
+            } else {
+                f = (b & c) | (d & (b | c));        // majority
+            }
+
+            e += rotl(a, 5) + f + w(T);
+            b = rotl(b, 30);
+        }
+
+    /* The 80 rounds of one block, unrolled.
+     **/
+    template <typename Schedule>
+        inline void rounds(std::array<uint32_t, 5>& state, Schedule w) noexcept
+        {
+            auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+            round<0>(a, b, c, d, e, w);
+            round<1>(e, a, b, c, d, w);
+            round<2>(d, e, a, b, c, w);
+            round<3>(c, d, e, a, b, w);
+            round<4>(b, c, d, e, a, w);
+            round<5>(a, b, c, d, e, w);
+            round<6>(e, a, b, c, d, w);
+            round<7>(d, e, a, b, c, w);
+            round<8>(c, d, e, a, b, w);
+            round<9>(b, c, d, e, a, w);
+            round<10>(a, b, c, d, e, w);
+            round<11>(e, a, b, c, d, w);
+            round<12>(d, e, a, b, c, w);
+            round<13>(c, d, e, a, b, w);
+            round<14>(b, c, d, e, a, w);
+            round<15>(a, b, c, d, e, w);
+            round<16>(e, a, b, c, d, w);
+            round<17>(d, e, a, b, c, w);
+            round<18>(c, d, e, a, b, w);
+            round<19>(b, c, d, e, a, w);
+            round<20>(a, b, c, d, e, w);
+            round<21>(e, a, b, c, d, w);
+            round<22>(d, e, a, b, c, w);
+            round<23>(c, d, e, a, b, w);
+            round<24>(b, c, d, e, a, w);
+            round<25>(a, b, c, d, e, w);
+            round<26>(e, a, b, c, d, w);
+            round<27>(d, e, a, b, c, w);
+            round<28>(c, d, e, a, b, w);
+            round<29>(b, c, d, e, a, w);
+            round<30>(a, b, c, d, e, w);
+            round<31>(e, a, b, c, d, w);
+            round<32>(d, e, a, b, c, w);
+            round<33>(c, d, e, a, b, w);
+            round<34>(b, c, d, e, a, w);
+            round<35>(a, b, c, d, e, w);
+            round<36>(e, a, b, c, d, w);
+            round<37>(d, e, a, b, c, w);
+            round<38>(c, d, e, a, b, w);
+            round<39>(b, c, d, e, a, w);
+            round<40>(a, b, c, d, e, w);
+            round<41>(e, a, b, c, d, w);
+            round<42>(d, e, a, b, c, w);
+            round<43>(c, d, e, a, b, w);
+            round<44>(b, c, d, e, a, w);
+            round<45>(a, b, c, d, e, w);
+            round<46>(e, a, b, c, d, w);
+            round<47>(d, e, a, b, c, w);
+            round<48>(c, d, e, a, b, w);
+            round<49>(b, c, d, e, a, w);
+            round<50>(a, b, c, d, e, w);
+            round<51>(e, a, b, c, d, w);
+            round<52>(d, e, a, b, c, w);
+            round<53>(c, d, e, a, b, w);
+            round<54>(b, c, d, e, a, w);
+            round<55>(a, b, c, d, e, w);
+            round<56>(e, a, b, c, d, w);
+            round<57>(d, e, a, b, c, w);
+            round<58>(c, d, e, a, b, w);
+            round<59>(b, c, d, e, a, w);
+            round<60>(a, b, c, d, e, w);
+            round<61>(e, a, b, c, d, w);
+            round<62>(d, e, a, b, c, w);
+            round<63>(c, d, e, a, b, w);
+            round<64>(b, c, d, e, a, w);
+            round<65>(a, b, c, d, e, w);
+            round<66>(e, a, b, c, d, w);
+            round<67>(d, e, a, b, c, w);
+            round<68>(c, d, e, a, b, w);
+            round<69>(b, c, d, e, a, w);
+            round<70>(a, b, c, d, e, w);
+            round<71>(e, a, b, c, d, w);
+            round<72>(d, e, a, b, c, w);
+            round<73>(c, d, e, a, b, w);
+            round<74>(b, c, d, e, a, w);
+            round<75>(a, b, c, d, e, w);
+            round<76>(e, a, b, c, d, w);
+            round<77>(d, e, a, b, c, w);
+            round<78>(c, d, e, a, b, w);
+            round<79>(b, c, d, e, a, w);
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+        }
+
+    /* Compresses nblocks consecutive 64 bytes blocks (possibly unaligned) into state.
+     *
+     * The message schedule is computed on the fly in a rolling window of 16 words, W[t % 16],
+     * whose indices are literals once the unrolled rounds are inlined.
+     **/
+    inline void compress(std::array<uint32_t, 5>& state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            uint32_t W[16];
+
+            // the block may be unaligned
+            std::memcpy(W, blocks, sizeof(W));
+            for (auto& w : W) {
+                w = htobe32(w);
+            }
+
+            rounds(state, [&W](unsigned int t) {
+                if (t >= 16) {
+                    W[t & 15] = rotl(W[(t + 13) & 15] ^ W[(t + 8) & 15] ^ W[(t + 2) & 15] ^ W[t & 15], 1);
+                }
+                return W[t & 15] + K[t / 20];
+            });
+        }
+    }
+
+    /* Compresses one block whose schedule, W[t] + K[t / 20] for the 80 rounds, is already
+     * expanded in wk (see expandSSSE3() and expandAVX2()).
+     **/
+    inline void compressExpanded(std::array<uint32_t, 5>& state, const uint32_t* wk) noexcept
+    {
+        rounds(state, [wk](unsigned int t) { return wk[t]; });
+    }
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+    /* Same as compress() with the x86 SHA extensions, only available to code built for them.
+     **/
+    inline void compressSHANI(uint32_t* state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+        auto abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+        auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+        abcd = _mm_shuffle_epi32(abcd, 0x1B);
+
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            const auto abcdSave = abcd;
+            const auto e0Save = e0;
+            __m128i e1;
+
+            auto load = [&](unsigned int i) {
+                auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i));
+                return _mm_shuffle_epi8(w, MASK);
+            };
+
+            // Rounds 0-3
+            auto m0 = load(0);
+            e0 = _mm_add_epi32(e0, m0);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+            // Rounds 4-7
+            auto m1 = load(1);
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+
+            // Rounds 8-11
+            auto m2 = load(2);
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 12-15
+            auto m3 = load(3);
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 16-19
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 20-23
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 24-27
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 28-31
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 32-35
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 36-39
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 40-43
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 44-47
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 48-51
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 52-55
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 56-59
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 60-63
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 64-67
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 68-71
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 72-75
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+            // Rounds 76-79
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+            // add this block's hash to the state, E is recovered from the rotated A of round 76
+            e0 = _mm_sha1nexte_epu32(e0, e0Save);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+        }
+
+        abcd = _mm_shuffle_epi32(abcd, 0x1B);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+        state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+    }
+#endif
+
+} /* namespace sha1_detail */
+} /* namespace crypto */
+
+#endif /* _SHA1_KERNEL_ */
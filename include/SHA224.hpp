@@ -22,6 +22,11 @@ namespace crypto {
             SHA224hashing(SHA224hashing&& other) = default;
             SHA224hashing& operator=(SHA224hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            SHA224hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             class SHA224BlockCipherLike final : public SHA256224BlockCipherLike
@@ -22,6 +22,11 @@ namespace crypto {
             SHA256hashing(SHA256hashing&& other) = default;
             SHA256hashing& operator=(SHA256hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            SHA256hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             class SHA256BlockCipherLike final : public SHA256224BlockCipherLike
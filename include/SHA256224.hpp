@@ -10,6 +10,12 @@ namespace crypto {
     template <size_t N>
         using SHA256224hash = CryptoHash<N>;
 
+    namespace sha256224_detail {
+        // x86 SHA extensions kernel (src/SHA256224_SHANI.cpp), only valid when hasSHANI() is true
+        bool hasSHANI(void);
+        void processBlocksSHANI(uint32_t* state, const uint8_t* blocks, size_t nblocks);
+    } /* namespace sha256224_detail */
+
     template <size_t N_digest>
         class SHA256224hashing : public HashingStrategy<SHA256224_TMPHASH_SIZE, N_digest>
     {
@@ -33,7 +39,7 @@ namespace crypto {
             class SHA256224BlockCipherLike : public HS<N_digest>::StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override;
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override;
                     virtual SHA256224hash<N_digest> getDigest(void) final override;
                     virtual void setMsgSize(size_t size) final override;
 
@@ -51,6 +57,9 @@ namespace crypto {
             };
 
             SHA256224hashing(std::unique_ptr< typename HS<N_digest>::StrategyBlockCipherLike >&& p);
+
+            template <typename Cipher>
+                SHA256224hashing(InPlace<Cipher> tag);
     };
 
 } /* namespace crypto */
@@ -0,0 +1,226 @@
+#ifndef _SHA256224_KERNEL_
+#define _SHA256224_KERNEL_
+
+#include "SHA256224Constants.hpp"
+#include "endian.hpp"
+
+#include <cstring>
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace sha256224_detail {
+
+    // Rotation by a constant amount, which compilers turn into a single rotate instruction
+    // (utils::rotate_right asserts on its amount and is not always folded as well).
+    inline uint32_t rotr(uint32_t x, unsigned int n) noexcept
+    {
+#if defined(__clang__)
+        return __builtin_rotateright32(x, n);
+#else
+        return (x >> n) | (x << (32 - n));
+#endif
+    }
+
+    inline uint32_t ep0(uint32_t x) noexcept { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
+    inline uint32_t ep1(uint32_t x) noexcept { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
+    inline uint32_t sig0(uint32_t x) noexcept { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3); }
+    inline uint32_t sig1(uint32_t x) noexcept { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10); }
+
+    /* One round on the working variables as named at round t; the caller shifts the names
+     * by one for round t + 1 instead of moving the values: only d and h are written.
+     **/
+    inline void round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d,
+                      uint32_t e, uint32_t f, uint32_t g, uint32_t& h, uint32_t kw) noexcept
+    {
+        auto t1 = h + ep1(e) + (g ^ (e & (f ^ g))) + kw;
+        auto t2 = ep0(a) + ((a & b) | (c & (a | b)));
+        d += t1;
+        h = t1 + t2;
+    }
+
+    /* Compresses nblocks consecutive 64 bytes blocks (possibly unaligned) into state.
+     *
+     * The rounds are unrolled 16 at a time, with the working variables renamed rather than
+     * moved, and the message schedule is computed on the fly in a rolling window of 16
+     * words, W[t % 16], instead of a 64 words array built upfront.
+     **/
+    inline void compress(std::array<uint32_t, 8>& state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            uint32_t W[16];
+
+            // the block may be unaligned
+            std::memcpy(W, blocks, sizeof(W));
+            for (auto& w : W) {
+                w = htobe32(w);
+            }
+
+            auto a = state[0], b = state[1], c = state[2], d = state[3];
+            auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+            // W[t] for t >= 16 replaces W[t - 16] in the window; the window indices are
+            // literals once the 16 rounds below are inlined, so the words stay in registers
+            auto w = [&W](unsigned int t, unsigned int i) {
+                if (t > 0) {
+                    W[i] += sig1(W[(i + 14) & 15]) + W[(i + 9) & 15] + sig0(W[(i + 1) & 15]);
+                }
+                return W[i];
+            };
+
+            for (unsigned int t = 0; t < 64; t += 16) {
+                const uint32_t* k = &K[t];
+                round(a, b, c, d, e, f, g, h, k[0] + w(t, 0));
+                round(h, a, b, c, d, e, f, g, k[1] + w(t, 1));
+                round(g, h, a, b, c, d, e, f, k[2] + w(t, 2));
+                round(f, g, h, a, b, c, d, e, k[3] + w(t, 3));
+                round(e, f, g, h, a, b, c, d, k[4] + w(t, 4));
+                round(d, e, f, g, h, a, b, c, k[5] + w(t, 5));
+                round(c, d, e, f, g, h, a, b, k[6] + w(t, 6));
+                round(b, c, d, e, f, g, h, a, k[7] + w(t, 7));
+                round(a, b, c, d, e, f, g, h, k[8] + w(t, 8));
+                round(h, a, b, c, d, e, f, g, k[9] + w(t, 9));
+                round(g, h, a, b, c, d, e, f, k[10] + w(t, 10));
+                round(f, g, h, a, b, c, d, e, k[11] + w(t, 11));
+                round(e, f, g, h, a, b, c, d, k[12] + w(t, 12));
+                round(d, e, f, g, h, a, b, c, k[13] + w(t, 13));
+                round(c, d, e, f, g, h, a, b, k[14] + w(t, 14));
+                round(b, c, d, e, f, g, h, a, k[15] + w(t, 15));
+            }
+
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+    }
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+    /* Four rounds: W + K for rounds 4i..4i+3 is computed from msg.
+     **/
+    inline void rounds4(__m128i& abef, __m128i& cdgh, __m128i msg, unsigned int i)
+    {
+        auto wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[4 * i])));
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+        wk = _mm_shuffle_epi32(wk, 0x0E);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+    }
+
+    /* Completes the next four schedule words held in next: W[t..t+3] from W[t-4..t-1] (cur),
+     * W[t-8..t-5] (prev) and the sigma0 part already folded in by sha256msg1.
+     **/
+    inline void schedule(__m128i& next, __m128i cur, __m128i prev)
+    {
+        next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4));
+        next = _mm_sha256msg2_epu32(next, cur);
+    }
+
+    /* Same as compress() with the x86 SHA extensions, only available to code built for them.
+     **/
+    inline void compressSHANI(uint32_t* state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // rearrange the state from A..H into the ABEF/CDGH layout of sha256rnds2
+        auto tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+        auto cdgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);              // CDAB
+        cdgh = _mm_shuffle_epi32(cdgh, 0x1B);            // EFGH
+        auto abef = _mm_alignr_epi8(tmp, cdgh, 8);       // ABEF
+        cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);         // CDGH
+
+        for (; nblocks > 0; --nblocks, blocks += 64) {
+            const auto abefSave = abef;
+            const auto cdghSave = cdgh;
+
+            auto load = [&](unsigned int i) {
+                auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i));
+                return _mm_shuffle_epi8(w, MASK);
+            };
+
+            auto m0 = load(0);
+            rounds4(abef, cdgh, m0, 0);
+
+            auto m1 = load(1);
+            rounds4(abef, cdgh, m1, 1);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            auto m2 = load(2);
+            rounds4(abef, cdgh, m2, 2);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            auto m3 = load(3);
+            rounds4(abef, cdgh, m3, 3);
+            schedule(m0, m3, m2);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            rounds4(abef, cdgh, m0, 4);
+            schedule(m1, m0, m3);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            rounds4(abef, cdgh, m1, 5);
+            schedule(m2, m1, m0);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            rounds4(abef, cdgh, m2, 6);
+            schedule(m3, m2, m1);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            rounds4(abef, cdgh, m3, 7);
+            schedule(m0, m3, m2);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            rounds4(abef, cdgh, m0, 8);
+            schedule(m1, m0, m3);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            rounds4(abef, cdgh, m1, 9);
+            schedule(m2, m1, m0);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            rounds4(abef, cdgh, m2, 10);
+            schedule(m3, m2, m1);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            rounds4(abef, cdgh, m3, 11);
+            schedule(m0, m3, m2);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            rounds4(abef, cdgh, m0, 12);
+            schedule(m1, m0, m3);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            rounds4(abef, cdgh, m1, 13);
+            schedule(m2, m1, m0);
+
+            rounds4(abef, cdgh, m2, 14);
+            schedule(m3, m2, m1);
+
+            rounds4(abef, cdgh, m3, 15);
+
+            abef = _mm_add_epi32(abef, abefSave);
+            cdgh = _mm_add_epi32(cdgh, cdghSave);
+        }
+
+        // back to the A..H layout
+        tmp = _mm_shuffle_epi32(abef, 0x1B);             // FEBA
+        cdgh = _mm_shuffle_epi32(cdgh, 0xB1);            // DCHG
+        abef = _mm_blend_epi16(tmp, cdgh, 0xF0);         // DCBA
+        cdgh = _mm_alignr_epi8(cdgh, tmp, 8);            // HGFE
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), abef);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), cdgh);
+    }
+#endif
+
+} /* namespace sha256224_detail */
+} /* namespace crypto */
+
+#endif /* _SHA256224_KERNEL_ */
@@ -22,6 +22,11 @@ namespace crypto {
             SHA384hashing(SHA384hashing&& other) = default;
             SHA384hashing& operator=(SHA384hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            SHA384hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             class SHA384BlockCipherLike final : public SHA512384BlockCipherLike
@@ -22,6 +22,11 @@ namespace crypto {
             SHA512hashing(SHA512hashing&& other) = default;
             SHA512hashing& operator=(SHA512hashing&& other) = default;
 
+            // independent copy of the running hash, e.g. to get the digest of a prefix and go on
+            SHA512hashing clone(void) const;
+
+            virtual HashAlgorithm algorithm(void) const final override;
+
         private:
 
             class SHA512BlockCipherLike final : public SHA512384BlockCipherLike
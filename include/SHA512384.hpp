@@ -10,6 +10,12 @@ namespace crypto {
     template <size_t N>
         using SHA512384hash = CryptoHash<N>;
 
+    namespace sha512384_detail {
+        // AVX2 kernel (src/SHA512384_AVX2.cpp), only valid when hasAVX2() is true
+        bool hasAVX2(void);
+        void processBlocksAVX2(uint64_t* state, const uint8_t* blocks, size_t nblocks);
+    } /* namespace sha512384_detail */
+
     template <size_t N_digest>
         class SHA512384hashing : public HashingStrategy<SHA512384_TMPHASH_SIZE, N_digest, uint64_t>
     {
@@ -33,7 +39,7 @@ namespace crypto {
             class SHA512384BlockCipherLike : public HS<N_digest>::StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override;
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override;
                     virtual SHA512384hash<N_digest> getDigest(void) final override;
                     virtual void setMsgSize(size_t size) final override;
 
@@ -51,6 +57,9 @@ namespace crypto {
             };
 
             SHA512384hashing(std::unique_ptr< typename HS<N_digest>::StrategyBlockCipherLike >&& p);
+
+            template <typename Cipher>
+                SHA512384hashing(InPlace<Cipher> tag);
     };
 
 } /* namespace crypto */
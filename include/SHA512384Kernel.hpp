@@ -0,0 +1,80 @@
+#ifndef _SHA512384_KERNEL_
+#define _SHA512384_KERNEL_
+
+#include "SHA512384Constants.hpp"
+#include "utils.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace crypto {
+namespace sha512384_detail {
+
+    /* Compresses nblocks consecutive 128 bytes blocks (possibly unaligned) into state.
+     **/
+    inline void compress(std::array<uint64_t, 8>& state, const uint8_t* blocks, size_t nblocks) noexcept
+    {
+        using utils::rotate_right;
+
+        auto F0 = [](auto x, auto y, auto z) { return (x & y) | (z & (x | y)); };
+        auto F1 = [](auto x, auto y, auto z) { return z ^ (x & (y ^ z)); };
+
+        auto EP0 = [](uint64_t x) { return rotate_right(x,28) ^ rotate_right(x,34) ^ rotate_right(x,39); };
+        auto EP1 = [](uint64_t x) { return rotate_right(x,14) ^ rotate_right(x,18) ^ rotate_right(x,41); };
+
+        auto SIG0 = [](uint64_t x) { return rotate_right(x,1) ^ rotate_right(x,8) ^ (x >> 7); };
+        auto SIG1 = [](uint64_t x) { return rotate_right(x,19) ^ rotate_right(x,61) ^ (x >> 6); };
+
+        for (; nblocks > 0; --nblocks, blocks += 128) {
+            std::array<uint64_t, 80> W; // word sequence
+            uint64_t A, B, C, D, E, F, G, H; // word buffers
+
+            // initialize the first 16 words in the array W with the message block (the block may be unaligned)
+            std::memcpy(W.data(), blocks, 128);
+            std::transform(W.cbegin(),
+                           std::next(W.cbegin(), 16),
+                           W.begin(),
+                           [] (uint64_t n) { return htobe64(n); });
+
+            for (auto t = 16U; t < W.size(); ++t) {
+                W[t] = SIG1(W[t - 2]) + W[t - 7] + SIG0(W[t - 15]) + W[t - 16];
+            }
+
+            A = state[0];
+            B = state[1];
+            C = state[2];
+            D = state[3];
+            E = state[4];
+            F = state[5];
+            G = state[6];
+            H = state[7];
+
+            for (auto t = 0U; t < W.size(); ++t) {
+                auto T1 = H + EP1(E) + F1(E,F,G) + K[t] + W[t];
+                auto T2 = EP0(A) + F0(A,B,C);
+                H = G;
+                G = F;
+                F = E;
+                E = D + T1;
+                D = C;
+                C = B;
+                B = A;
+                A = T1 + T2;
+            }
+
+            state[0] += A;
+            state[1] += B;
+            state[2] += C;
+            state[3] += D;
+            state[4] += E;
+            state[5] += F;
+            state[6] += G;
+            state[7] += H;
+        }
+    }
+
+} /* namespace sha512384_detail */
+} /* namespace crypto */
+
+#endif /* _SHA512384_KERNEL_ */
@@ -0,0 +1,158 @@
+#ifndef _STATIC_HASHER_HPP
+#define _STATIC_HASHER_HPP
+
+#include "HashingStrategy.hpp"
+#include "MD4Kernel.hpp"
+#include "MD5Kernel.hpp"
+#include "SHA1Kernel.hpp"
+#include "SHA256224Kernel.hpp"
+#include "SHA512384Kernel.hpp"
+
+namespace crypto {
+
+    /* Algorithm policies of StaticHasher: the block geometry, the padding layout and the
+     * compression function of each algorithm, all resolved at compile time.
+     *
+     * The SHA-1 and SHA-256 policies compress with the x86 SHA extensions when the including
+     * translation unit is built for them (-msha -msse4.1, or a -march which has them) and with
+     * the portable rounds otherwise; there is no runtime dispatch in this header-only path.
+     **/
+    namespace algo {
+
+        template <typename T_word, size_t N_stateWords, size_t N_digest, bool B_bigEndian>
+            struct Geometry
+            {
+                using Word = T_word;
+                using State = std::array<T_word, N_stateWords>;
+
+                static constexpr size_t BLOCK_SIZE = 16 * sizeof(T_word);
+                static constexpr size_t LENGTH_SIZE = 2 * sizeof(T_word); // message length field
+                static constexpr size_t DIGEST_SIZE = N_digest;
+                static constexpr bool BIG_ENDIAN_WORDS = B_bigEndian;
+            };
+
+        struct MD4 : Geometry<uint32_t, 4, 16, false>
+        {
+            static constexpr State iv(void) { return md4_detail::IV; }
+            static void compress(State& state, const uint8_t* blocks, size_t nblocks) noexcept
+            {
+                md4_detail::compress(state, blocks, nblocks);
+            }
+        };
+
+        struct MD5 : Geometry<uint32_t, 4, 16, false>
+        {
+            static constexpr State iv(void) { return md5_detail::IV; }
+            static void compress(State& state, const uint8_t* blocks, size_t nblocks) noexcept
+            {
+                md5_detail::compress(state, blocks, nblocks);
+            }
+        };
+
+        struct SHA1 : Geometry<uint32_t, 5, 20, true>
+        {
+            static constexpr State iv(void) { return sha1_detail::IV; }
+            static void compress(State& state, const uint8_t* blocks, size_t nblocks) noexcept
+            {
+#if defined(__SHA__) && defined(__SSE4_1__)
+                sha1_detail::compressSHANI(state.data(), blocks, nblocks);
+#else
+                sha1_detail::compress(state, blocks, nblocks);
+#endif
+            }
+        };
+
+        template <size_t N_digest>
+            struct SHA256224 : Geometry<uint32_t, 8, N_digest, true>
+            {
+                using State = typename Geometry<uint32_t, 8, N_digest, true>::State;
+
+                static void compress(State& state, const uint8_t* blocks, size_t nblocks) noexcept
+                {
+#if defined(__SHA__) && defined(__SSE4_1__)
+                    sha256224_detail::compressSHANI(state.data(), blocks, nblocks);
+#else
+                    sha256224_detail::compress(state, blocks, nblocks);
+#endif
+                }
+            };
+
+        struct SHA224 : SHA256224<28>
+        {
+            static constexpr State iv(void) { return sha256224_detail::IV224; }
+        };
+
+        struct SHA256 : SHA256224<32>
+        {
+            static constexpr State iv(void) { return sha256224_detail::IV256; }
+        };
+
+        template <size_t N_digest>
+            struct SHA512384 : Geometry<uint64_t, 8, N_digest, true>
+            {
+                using State = typename Geometry<uint64_t, 8, N_digest, true>::State;
+
+                static void compress(State& state, const uint8_t* blocks, size_t nblocks) noexcept
+                {
+                    sha512384_detail::compress(state, blocks, nblocks);
+                }
+            };
+
+        struct SHA384 : SHA512384<48>
+        {
+            static constexpr State iv(void) { return sha512384_detail::IV384; }
+        };
+
+        struct SHA512 : SHA512384<64>
+        {
+            static constexpr State iv(void) { return sha512384_detail::IV512; }
+        };
+
+    } /* namespace algo */
+
+    /* Compile-time counterpart of the HashingStrategy hierarchy: the same update()/getHash()
+     * semantics and digests, but the whole context (state, partial block, length) lives
+     * inside the object, nothing is virtual and everything is inlinable. Meant for hot
+     * loops and short messages where the virtual calls and the per-block indirect call of
+     * the runtime-polymorphic hashers show.
+     *
+     * Unlike the other hashers a StaticHasher is copyable, a copy forks the running hash.
+     **/
+    template <typename Algo>
+        class StaticHasher
+        {
+            public:
+
+                using Digest = CryptoHash<Algo::DIGEST_SIZE>;
+
+                StaticHasher(void) noexcept;
+
+                bool update(gsl::span<const uint8_t> &buf) noexcept;
+                Digest getHash(void) noexcept;
+
+            private:
+
+                void reset(void) noexcept;
+
+                // maximum length of a hashed message (in bytes)
+                static constexpr uint64_t MAX_MSG_LENGTH = 1ULL << 61;
+
+                typename Algo::State m_state;
+                std::array<uint8_t, Algo::BLOCK_SIZE> m_block;
+                size_t m_blockFill; // bytes buffered in m_block
+                uint64_t m_msgLength; // length of the message (in bytes)
+        };
+
+    using StaticMD4hashing = StaticHasher<algo::MD4>;
+    using StaticMD5hashing = StaticHasher<algo::MD5>;
+    using StaticSHA1hashing = StaticHasher<algo::SHA1>;
+    using StaticSHA224hashing = StaticHasher<algo::SHA224>;
+    using StaticSHA256hashing = StaticHasher<algo::SHA256>;
+    using StaticSHA384hashing = StaticHasher<algo::SHA384>;
+    using StaticSHA512hashing = StaticHasher<algo::SHA512>;
+
+} /* namespace crypto */
+
+#include "StaticHasher.ipp"
+
+#endif /* _STATIC_HASHER_HPP */
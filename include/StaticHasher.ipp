@@ -0,0 +1,102 @@
+#include "Padding.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace crypto {
+
+    template <typename Algo>
+        constexpr uint64_t StaticHasher<Algo>::MAX_MSG_LENGTH;
+
+    template <typename Algo>
+        StaticHasher<Algo>::StaticHasher(void) noexcept
+        {
+            reset();
+        }
+
+    template <typename Algo>
+        void StaticHasher<Algo>::reset(void) noexcept
+        {
+            m_state = Algo::iv();
+            m_block.fill(0);
+            m_blockFill = 0;
+            m_msgLength = 0;
+        }
+
+    template <typename Algo>
+        bool StaticHasher<Algo>::update(gsl::span<const uint8_t> &buf) noexcept
+        {
+            // an empty piece, whose data may be null, leaves the message as it is
+            if (buf.empty()) {
+                return true;
+            }
+
+            auto size = static_cast<size_t>(buf.size());
+            if (m_msgLength + size > MAX_MSG_LENGTH) {
+                return false;
+            }
+            m_msgLength += size;
+
+            auto data = buf.data();
+
+            // complete the buffered block first
+            if (m_blockFill > 0) {
+                auto n = std::min(Algo::BLOCK_SIZE - m_blockFill, size);
+                std::memcpy(m_block.data() + m_blockFill, data, n);
+                m_blockFill += n;
+                data += n;
+                size -= n;
+
+                if (m_blockFill < Algo::BLOCK_SIZE) {
+                    return true;
+                }
+                Algo::compress(m_state, m_block.data(), 1);
+                m_blockFill = 0;
+            }
+
+            // full blocks straight from the caller's buffer, only the tail is copied
+            auto nblocks = size / Algo::BLOCK_SIZE;
+            if (nblocks > 0) {
+                Algo::compress(m_state, data, nblocks);
+                data += nblocks * Algo::BLOCK_SIZE;
+                size -= nblocks * Algo::BLOCK_SIZE;
+            }
+
+            std::memcpy(m_block.data(), data, size);
+            m_blockFill = size;
+
+            return true;
+        }
+
+    template <typename Algo>
+        typename StaticHasher<Algo>::Digest StaticHasher<Algo>::getHash(void) noexcept
+        {
+            using Word = typename Algo::Word;
+
+            // the padding and the length, in a new block when there is no room left for them
+            padding_detail::padTail<Algo::BLOCK_SIZE, Algo::LENGTH_SIZE, Algo::BIG_ENDIAN_WORDS>(
+                m_block.data(), m_blockFill, m_msgLength, [this](uint8_t* block) {
+                    Algo::compress(m_state, block, 1);
+                    return block;
+                });
+            Algo::compress(m_state, m_block.data(), 1);
+
+            // serialize the state, truncated to the digest size (SHA-224, SHA-384)
+            Digest digest;
+            for (size_t i = 0; i < Algo::DIGEST_SIZE / sizeof(Word); ++i) {
+                Word w = m_state[i];
+                if (sizeof(Word) == sizeof(uint64_t)) {
+                    w = static_cast<Word>(Algo::BIG_ENDIAN_WORDS ? htobe64(w) : htole64(w));
+                } else {
+                    w = static_cast<Word>(Algo::BIG_ENDIAN_WORDS ? htobe32(w) : htole32(w));
+                }
+                std::memcpy(digest.data() + i * sizeof(Word), &w, sizeof(Word));
+            }
+
+            // message may be sensitive, clear it out
+            reset();
+
+            return digest;
+        }
+
+} /* namespace crypto */
@@ -0,0 +1,54 @@
+#ifndef _CRYPTO_THREAD_POOL_HPP
+#define _CRYPTO_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace crypto {
+
+    /* Fixed set of worker threads executing tasks in submission order.
+     **/
+    class ThreadPool
+    {
+        public:
+
+            // threads == 0 means one worker per hardware thread
+            explicit ThreadPool(size_t threads = 0);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+
+            size_t size(void) const;
+
+            void submit(std::function<void()> task);
+
+            /* Calls fn(i) for every i in [0, n) on the workers and on the calling
+             * thread, and returns once all the calls are done. Safe to call from
+             * a task running on the pool itself.
+             **/
+            void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+
+            /* Process-wide pool with one worker per hardware thread.
+             **/
+            static ThreadPool& shared(void);
+
+        private:
+
+            void work(void);
+
+            std::vector<std::thread> m_workers;
+            std::deque<std::function<void()>> m_tasks;
+            std::mutex m_mutex;
+            std::condition_variable m_wakeup;
+            bool m_stopping;
+    };
+
+} /* namespace crypto */
+
+#endif /* _CRYPTO_THREAD_POOL_HPP */
@@ -0,0 +1,83 @@
+#ifndef _TREE_HASHING_
+#define _TREE_HASHING_
+
+#include "HashingStrategy.hpp"
+#include "ThreadPool.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace crypto {
+
+    /* Merkle tree hash mode over SHA256hashing or SHA512hashing, whose leaves are hashed
+     * in parallel on a thread pool.
+     *
+     * The digest is NOT the plain SHA-256/SHA-512 of the input and depends on the leaf size,
+     * so both sides must agree on it. With H the underlying hash and L the leaf size:
+     *  - the input is cut into leaves of L bytes, the last one may be shorter; an empty
+     *    input is a single empty leaf;
+     *  - a leaf hashes to H(0x00 || leaf), an inner node to H(0x01 || left || right);
+     *  - for n > 1 leaves the root is node(root(leaves[0, k)), root(leaves[k, n))) where k
+     *    is the largest power of two below n (the tree shape of RFC 6962, section 2.1).
+     *
+     * Small update() calls are gathered in a buffer of MAX_PENDING_LEAVES leaves, hashed
+     * side by side once full: the memory of a hasher does not grow with the number of
+     * workers, but the buffered input only keeps that many of them busy. Larger inputs are
+     * hashed straight from the caller's buffer, in batches of pool.size() leaves.
+     **/
+    template <typename Hasher>
+        class TreeHashing
+        {
+            public:
+
+                using Digest = decltype(std::declval<Hasher&>().getHash());
+
+                static constexpr size_t DEFAULT_LEAF_SIZE = 1024 * 1024;
+
+                // leaves buffered at most, e.g. 4 MiB with the default leaf size
+                static constexpr size_t MAX_PENDING_LEAVES = 4;
+
+                explicit TreeHashing(size_t leafSize = DEFAULT_LEAF_SIZE, ThreadPool& pool = ThreadPool::shared());
+                ~TreeHashing() = default;
+
+                TreeHashing(const TreeHashing& other) = delete;
+                TreeHashing& operator=(const TreeHashing& other) = delete;
+
+                TreeHashing(TreeHashing&& other) = default;
+                TreeHashing& operator=(TreeHashing&& other) = default;
+
+                bool update(gsl::span<const uint8_t> &buf);
+                Digest getHash(void);
+
+                size_t leafSize(void) const;
+
+            private:
+
+                static constexpr uint8_t LEAF_PREFIX = 0x00;
+                static constexpr uint8_t NODE_PREFIX = 0x01;
+
+                static Digest hashLeaf(const uint8_t* leaf, size_t size);
+                static Digest hashNode(const Digest& left, const Digest& right);
+
+                // hashes nleaves full leaves on the pool and appends them to the tree
+                void addLeaves(const uint8_t* leaves, size_t nleaves);
+                void addLeaf(const Digest& digest);
+                void reset(void);
+
+                size_t m_leafSize;
+                ThreadPool* m_pool;
+                size_t m_batch;     // leaves hashed at once, one per worker
+
+                std::vector<uint8_t> m_pending;
+                size_t m_pendingSize;
+                uint64_t m_leafCount;
+
+                // roots of the complete subtrees built so far, with their height
+                std::vector<std::pair<Digest, unsigned>> m_subtrees;
+        };
+
+} /* namespace crypto */
+
+#include "TreeHashing.ipp"
+
+#endif
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cassert>
+
+namespace crypto {
+
+    template <typename Hasher>
+        constexpr size_t TreeHashing<Hasher>::DEFAULT_LEAF_SIZE;
+
+    template <typename Hasher>
+        constexpr size_t TreeHashing<Hasher>::MAX_PENDING_LEAVES;
+
+    template <typename Hasher>
+        TreeHashing<Hasher>::TreeHashing(size_t leafSize, ThreadPool& pool) :
+            m_leafSize(leafSize),
+            m_pool(&pool),
+            m_batch(std::max<size_t>(pool.size(), 1)),
+            m_pending(leafSize * std::min(m_batch, MAX_PENDING_LEAVES)),
+            m_pendingSize(0),
+            m_leafCount(0)
+    {
+        assert(leafSize > 0);
+    }
+
+    template <typename Hasher>
+        size_t TreeHashing<Hasher>::leafSize(void) const
+        {
+            return m_leafSize;
+        }
+
+    template <typename Hasher>
+        bool TreeHashing<Hasher>::update(gsl::span<const uint8_t> &buf)
+        {
+            // an empty piece, whose data may be null, leaves the message as it is
+            if (buf.empty()) {
+                return true;
+            }
+
+            auto in(buf);
+            while ( !in.empty() ) {
+                // Nothing buffered and at least a batch of leaves available: hash every
+                // full leaf straight from the caller's buffer, only the tail is copied.
+                if (m_pendingSize == 0 && static_cast<size_t>(in.size()) >= m_pending.size()) {
+                    auto nleaves = static_cast<size_t>(in.size()) / m_leafSize;
+                    addLeaves(in.data(), nleaves);
+                    in = in.subspan(nleaves * m_leafSize);
+                    continue;
+                }
+
+                auto n = std::min(m_pending.size() - m_pendingSize, static_cast<size_t>(in.size()));
+                std::copy_n(in.begin(), n, m_pending.begin() + m_pendingSize);
+                in = in.subspan(n);
+                m_pendingSize += n;
+
+                if (m_pendingSize == m_pending.size()) {
+                    addLeaves(m_pending.data(), m_pending.size() / m_leafSize);
+                    m_pendingSize = 0;
+                }
+            }
+
+            return true;
+        }
+
+    template <typename Hasher>
+        typename TreeHashing<Hasher>::Digest TreeHashing<Hasher>::getHash(void)
+        {
+            auto nleaves = m_pendingSize / m_leafSize;
+            addLeaves(m_pending.data(), nleaves);
+
+            // the last leaf is the only one which may be short, or even empty
+            auto tail = m_pendingSize % m_leafSize;
+            if (tail > 0 || m_leafCount == 0) {
+                addLeaf(hashLeaf(m_pending.data() + nleaves * m_leafSize, tail));
+            }
+
+            // fold the complete subtrees from the right: the smallest one is the
+            // right child of its left neighbour's parent
+            while (m_subtrees.size() > 1) {
+                auto right = m_subtrees.back().first;
+                m_subtrees.pop_back();
+                m_subtrees.back().first = hashNode(m_subtrees.back().first, right);
+            }
+
+            auto root = m_subtrees.back().first;
+
+            // message may be sensitive, clear it out
+            reset();
+
+            return root;
+        }
+
+    template <typename Hasher>
+        typename TreeHashing<Hasher>::Digest TreeHashing<Hasher>::hashLeaf(const uint8_t* leaf, size_t size)
+        {
+            const uint8_t prefix[] = { LEAF_PREFIX };
+
+            Hasher hasher;
+            gsl::span<const uint8_t> in(prefix);
+            hasher.update(in);
+            if (size > 0) {
+                in = gsl::span<const uint8_t>(leaf, size);
+                hasher.update(in);
+            }
+            return hasher.getHash();
+        }
+
+    template <typename Hasher>
+        typename TreeHashing<Hasher>::Digest TreeHashing<Hasher>::hashNode(const Digest& left, const Digest& right)
+        {
+            const uint8_t prefix[] = { NODE_PREFIX };
+
+            Hasher hasher;
+            gsl::span<const uint8_t> in(prefix);
+            hasher.update(in);
+            in = gsl::span<const uint8_t>(left);
+            hasher.update(in);
+            in = gsl::span<const uint8_t>(right);
+            hasher.update(in);
+            return hasher.getHash();
+        }
+
+    template <typename Hasher>
+        void TreeHashing<Hasher>::addLeaves(const uint8_t* leaves, size_t nleaves)
+        {
+            // bound the digests in flight, a batch keeps every worker busy
+            std::vector<Digest> digests(std::min(nleaves, m_batch));
+
+            while (nleaves > 0) {
+                auto n = std::min(nleaves, m_batch);
+                m_pool->parallelFor(n, [&](size_t i) {
+                    digests[i] = hashLeaf(leaves + i * m_leafSize, m_leafSize);
+                });
+
+                for (size_t i = 0; i < n; ++i) {
+                    addLeaf(digests[i]);
+                }
+
+                leaves += n * m_leafSize;
+                nleaves -= n;
+            }
+        }
+
+    template <typename Hasher>
+        void TreeHashing<Hasher>::addLeaf(const Digest& digest)
+        {
+            // merge the subtrees of equal height, as a binary counter would carry
+            m_subtrees.emplace_back(digest, 0);
+            while (m_subtrees.size() > 1 && m_subtrees[m_subtrees.size() - 2].second == m_subtrees.back().second) {
+                auto right = m_subtrees.back().first;
+                m_subtrees.pop_back();
+                m_subtrees.back().first = hashNode(m_subtrees.back().first, right);
+                ++m_subtrees.back().second;
+            }
+            ++m_leafCount;
+        }
+
+    template <typename Hasher>
+        void TreeHashing<Hasher>::reset(void)
+        {
+            std::fill(m_pending.begin(), m_pending.begin() + m_pendingSize, 0);
+            m_pendingSize = 0;
+            m_leafCount = 0;
+            m_subtrees.clear();
+        }
+
+} /* namespace crypto */
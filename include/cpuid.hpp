@@ -0,0 +1,26 @@
+#ifndef _CRYPTO_CPUID_HPP
+#define _CRYPTO_CPUID_HPP
+
+namespace crypto {
+namespace cpuid {
+
+/* Instruction set extensions of the host CPU that the library has kernels for.
+ * All flags are false on non-x86 hosts.
+ **/
+struct Features
+{
+    bool ssse3;
+    bool sse41;
+    bool avx2;      // only set when the OS saves the YMM registers
+    bool avx512f;   // only set when the OS saves the ZMM registers
+    bool sha;       // SHA-1 and SHA-256 extensions (SHA-NI)
+};
+
+/* Features of the host CPU, detected once on first use.
+ **/
+const Features& features(void);
+
+} /* namespace cpuid */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_CPUID_HPP */
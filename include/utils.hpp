@@ -1,6 +1,7 @@
 #ifndef _CRYPTO_UTILS_HPP
 #define _CRYPTO_UTILS_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace crypto {
@@ -16,6 +17,12 @@ inline T rotate_left(const T& x, uint8_t n);
 template <typename T>
 inline T rotate_right(const T& x, uint8_t n);
 
+/* Overwrites the n bytes at p with zeroes, even though they are not read afterwards, as
+ * the compiler would otherwise be free to drop the stores: for the copies of a message,
+ * which may be sensitive, left on the stack.
+ **/
+inline void wipe(void* p, size_t n);
+
 } /* namespace utils */
 } /* namespace crypto */
 
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cstring>
 
 namespace crypto {
 namespace utils {
@@ -27,6 +28,20 @@ inline T rotate_right(const T& x, uint8_t n)
     return rotated;
 }
 
+inline void wipe(void* p, size_t n)
+{
+#if defined(__GNUC__)
+    std::memset(p, 0, n);
+    // the zeroes may be read by anything through p, as far as the compiler knows
+    __asm__ volatile("" : : "r"(p) : "memory");
+#else
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(p);
+    for (size_t i = 0; i < n; ++i) {
+        bytes[i] = 0;
+    }
+#endif
+}
+
 } /* namespace utils */
 } /* namespace crypto */
 
@@ -0,0 +1,665 @@
+#include "AsyncHashFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define CRYPTO_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace crypto {
+namespace file_detail {
+
+static const size_t READ_ALIGNMENT = 4096;
+
+#if defined(CRYPTO_TESTING)
+static std::atomic<int> g_uringError {0};
+
+void injectUringError(int error)
+{
+    g_uringError = error;
+}
+#endif
+
+namespace {
+
+    /* One read buffer; a read may complete in several pieces, filled tells how much of
+     * length is already there.
+     **/
+    struct Buffer
+    {
+        uint8_t* data;
+        struct iovec iov;
+        struct File* file;
+        uint64_t offset;
+        size_t length;
+        size_t filled;
+        bool reading;               // handed to the reader and not completed yet
+    };
+
+    struct File
+    {
+        size_t index;
+        int fd = -1;
+        uint64_t size = 0;
+        uint64_t nextRead = 0;      // offset of the next read to issue
+        uint64_t nextHash = 0;      // offset of the next chunk to consume
+        size_t inflight = 0;        // reads issued and not completed
+        std::map<uint64_t, Buffer*> ready;
+        bool hashing = false;       // a task of the pool works on this file
+        bool failed = false;
+        bool streamed = false;      // read by readFile() in a task rather than by the reader
+    };
+
+    struct Completion
+    {
+        Buffer* buffer;
+        long result;                // bytes read, or -errno
+    };
+
+    /* Issues reads and reports their completions, to a single thread.
+     **/
+    class Reader
+    {
+        public:
+            virtual ~Reader() = default;
+
+            virtual void submit(int fd, Buffer* buffer) = 0;
+
+            /* Appends completions to out, waiting for at least one when wait is set. Returns
+             * false when the reader broke down: the reads it still has will never be reported.
+             **/
+            virtual bool reap(std::vector<Completion>& out, bool wait) = 0;
+    };
+
+    /* pread() on dedicated threads, the portable fallback.
+     **/
+    class PoolReader final : public Reader
+    {
+        public:
+            explicit PoolReader(size_t threads) : m_io(threads) {}
+
+            void submit(int fd, Buffer* buffer) override
+            {
+                m_io.submit([this, fd, buffer] {
+                    long n;
+                    do {
+                        n = ::pread(fd, buffer->iov.iov_base, buffer->iov.iov_len,
+                                    static_cast<off_t>(buffer->offset + buffer->filled));
+                    } while (n < 0 && errno == EINTR);
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_done.push_back({ buffer, n < 0 ? -errno : n });
+                    }
+                    m_ready.notify_one();
+                });
+            }
+
+            bool reap(std::vector<Completion>& out, bool wait) override
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (wait) {
+                    m_ready.wait(lock, [this] { return !m_done.empty(); });
+                }
+                out.insert(out.end(), m_done.begin(), m_done.end());
+                m_done.clear();
+                return true;
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::deque<Completion> m_done;
+
+            // last member: its destructor waits for the reads still running
+            ThreadPool m_io;
+    };
+
+#if defined(CRYPTO_HAVE_IO_URING)
+    /* io_uring through the raw system calls. The rings hold one entry per buffer, so that
+     * the submission queue never fills up and the completion queue never overflows.
+     **/
+    class UringReader final : public Reader
+    {
+        public:
+            explicit UringReader(unsigned int entries)
+            {
+                struct io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+
+                m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (m_fd < 0) {
+                    return;
+                }
+
+                m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+                m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+                if (params.features & IORING_FEAT_SINGLE_MMAP) {
+                    m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+                }
+
+                m_sq = ::mmap(nullptr, m_sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+                m_cq = (params.features & IORING_FEAT_SINGLE_MMAP) ? m_sq :
+                    ::mmap(nullptr, m_cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+                m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+                m_sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+                if (m_sq == MAP_FAILED || m_cq == MAP_FAILED || m_sqes == MAP_FAILED) {
+                    release();
+                    return;
+                }
+
+                auto sq = static_cast<uint8_t*>(m_sq);
+                m_sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+                m_sqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+                m_sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+
+                auto cq = static_cast<uint8_t*>(m_cq);
+                m_cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+                m_cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+                m_cqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+                m_cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+            }
+
+            ~UringReader() override
+            {
+                release();
+            }
+
+            bool valid(void) const
+            {
+                return m_fd >= 0;
+            }
+
+            void submit(int fd, Buffer* buffer) override
+            {
+                // only this thread produces entries, the kernel reads the tail
+                auto tail = *m_sqTail;
+                auto index = tail & m_sqMask;
+                auto& sqe = static_cast<struct io_uring_sqe*>(m_sqes)[index];
+
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = fd;
+                sqe.off = buffer->offset + buffer->filled;
+                sqe.addr = reinterpret_cast<uint64_t>(&buffer->iov);
+                sqe.len = 1;
+                sqe.user_data = reinterpret_cast<uint64_t>(buffer);
+
+                m_sqArray[index] = index;
+                __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+                ++m_toSubmit;
+            }
+
+            bool reap(std::vector<Completion>& out, bool wait) override
+            {
+                bool entered = false;
+                for (;;) {
+#if defined(CRYPTO_TESTING)
+                    if (g_uringError != 0) {
+                        errno = g_uringError;
+                        break;
+                    }
+#endif
+                    auto submitted = ::syscall(__NR_io_uring_enter, m_fd, m_toSubmit, wait ? 1 : 0,
+                                               wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                    if (submitted >= 0) {
+                        m_toSubmit -= static_cast<unsigned int>(submitted);
+                        entered = true;
+                        break;
+                    }
+                    if (errno != EINTR) {
+                        // ENOMEM, EBUSY, EBADF...: the submissions would never drain
+                        break;
+                    }
+                }
+
+                // what completed before the failure is still reported
+                auto head = *m_cqHead;
+                auto tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head) {
+                    const auto& cqe = m_cqes[head & m_cqMask];
+                    out.push_back({ reinterpret_cast<Buffer*>(cqe.user_data), cqe.res });
+                }
+                __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+                return entered;
+            }
+
+        private:
+            void release(void)
+            {
+                if (m_sqes != nullptr && m_sqes != MAP_FAILED) ::munmap(m_sqes, m_sqesSize);
+                if (m_cq != nullptr && m_cq != MAP_FAILED && m_cq != m_sq) ::munmap(m_cq, m_cqSize);
+                if (m_sq != nullptr && m_sq != MAP_FAILED) ::munmap(m_sq, m_sqSize);
+                if (m_fd >= 0) ::close(m_fd);
+                m_fd = -1;
+                m_sq = m_cq = m_sqes = nullptr;
+            }
+
+            int m_fd = -1;
+            unsigned int m_toSubmit = 0;
+
+            void* m_sq = nullptr;
+            void* m_cq = nullptr;
+            void* m_sqes = nullptr;
+            size_t m_sqSize = 0;
+            size_t m_cqSize = 0;
+            size_t m_sqesSize = 0;
+
+            unsigned int* m_sqTail = nullptr;
+            unsigned int m_sqMask = 0;
+            unsigned int* m_sqArray = nullptr;
+
+            unsigned int* m_cqHead = nullptr;
+            unsigned int* m_cqTail = nullptr;
+            unsigned int m_cqMask = 0;
+            struct io_uring_cqe* m_cqes = nullptr;
+    };
+#endif
+
+    struct FreeDeleter
+    {
+        void operator()(void* p) const { std::free(p); }
+    };
+
+    /* State shared by the submitting thread and the hashing tasks, under m_mutex.
+     **/
+    class Pipeline
+    {
+        public:
+            Pipeline(const std::vector<std::string>& paths,
+                     const std::function<void(size_t)>& opened,
+                     const std::function<bool(size_t, gsl::span<const uint8_t>)>& consume,
+                     const FileProgress& progress,
+                     const std::function<void(size_t, bool)>& done,
+                     const AsyncHashOptions& options,
+                     ThreadPool& pool) :
+                m_paths(paths), m_opened(opened), m_consume(consume), m_progress(progress), m_done(done), m_pool(pool),
+                m_chunkSize((std::max<size_t>(options.chunkSize, 1) + READ_ALIGNMENT - 1) / READ_ALIGNMENT * READ_ALIGNMENT),
+                m_readsPerFile(std::max<size_t>(options.readsPerFile, 1)),
+                m_filesInFlight(std::max<size_t>(options.filesInFlight, 1))
+            {}
+
+            bool run(bool useIoUring);
+
+        private:
+            bool allocate(size_t count);
+            void abandon(void);
+            void open(File& file);
+            void issue(Reader& reader);
+            void complete(Reader& reader, const Completion& completion);
+            void schedule(File& file);
+            void hash(File& file);
+            void stream(File& file);
+            bool retire(std::unique_lock<std::mutex>& lock);
+            bool anyHashing(void) const;
+
+            const std::vector<std::string>& m_paths;
+            const std::function<void(size_t)>& m_opened;
+            const std::function<bool(size_t, gsl::span<const uint8_t>)>& m_consume;
+            const FileProgress& m_progress;
+            const std::function<void(size_t, bool)>& m_done;
+            ThreadPool& m_pool;
+
+            const size_t m_chunkSize;
+            const size_t m_readsPerFile;
+            const size_t m_filesInFlight;
+
+            // stable addresses, buffers are added when a reader breaks down
+            std::vector<std::unique_ptr<uint8_t, FreeDeleter>> m_memory;
+            std::deque<Buffer> m_buffers;
+            std::vector<Buffer*> m_free;
+
+            bool m_noBuffers = false;
+            size_t m_nextPath = 0;
+            std::vector<std::unique_ptr<File>> m_open;
+            size_t m_inflight = 0;      // reads in flight over all files
+
+            std::mutex m_mutex;
+            std::condition_variable m_changed;
+            uint64_t m_generation = 0;  // bumped by the tasks whenever they release something
+    };
+
+    bool Pipeline::allocate(size_t count)
+    {
+        void* p = nullptr;
+        if (::posix_memalign(&p, READ_ALIGNMENT, count * m_chunkSize) != 0) {
+            return false;
+        }
+        m_memory.emplace_back(static_cast<uint8_t*>(p));
+
+        for (size_t i = 0; i < count; ++i) {
+            Buffer buffer = {};
+            buffer.data = m_memory.back().get() + i * m_chunkSize;
+            m_buffers.push_back(buffer);
+            m_free.push_back(&m_buffers.back());
+        }
+        return true;
+    }
+
+    /* Fails the files whose reads are left with a reader which broke down. Their buffers may
+     * still be written by the kernel and are never used again: new ones take their place.
+     * Called with m_mutex held.
+     **/
+    void Pipeline::abandon(void)
+    {
+        size_t lost = 0;
+        for (auto& b : m_buffers) {
+            if (!b.reading) {
+                continue;
+            }
+            b.reading = false;
+            b.file->failed = true;
+            --b.file->inflight;
+            --m_inflight;
+            ++lost;
+        }
+
+        if (lost > 0 && !allocate(lost) && lost == m_buffers.size()) {
+            // nothing left to read with, the files still to read fail
+            m_noBuffers = true;
+        }
+    }
+
+    void Pipeline::open(File& file)
+    {
+        file.fd = ::open(m_paths[file.index].c_str(), O_RDONLY | O_CLOEXEC);
+        if (file.fd < 0) {
+            file.failed = true;
+            return;
+        }
+
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0) {
+            file.failed = true;
+            return;
+        }
+
+        if (S_ISREG(st.st_mode) && st.st_size > 0) {
+            file.size = static_cast<uint64_t>(st.st_size);
+            ::posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        } else {
+            // pipes, devices, empty files and the ones lying about their size (procfs)
+            file.streamed = true;
+            file.hashing = true;
+            m_pool.submit([this, &file] { stream(file); });
+        }
+    }
+
+    // called with m_mutex held
+    void Pipeline::issue(Reader& reader)
+    {
+        for (auto& file : m_open) {
+            auto& f = *file;
+            if (m_noBuffers && !f.streamed && f.nextRead < f.size) {
+                f.failed = true;
+            }
+            while (!f.failed && !f.streamed && f.nextRead < f.size && !m_free.empty() &&
+                    f.inflight + f.ready.size() < m_readsPerFile) {
+                auto b = m_free.back();
+                m_free.pop_back();
+
+                b->file = &f;
+                b->offset = f.nextRead;
+                b->length = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, f.size - f.nextRead));
+                b->filled = 0;
+                b->iov.iov_base = b->data;
+                b->iov.iov_len = b->length;
+                b->reading = true;
+
+                f.nextRead += b->length;
+                ++f.inflight;
+                ++m_inflight;
+                reader.submit(f.fd, b);
+            }
+        }
+    }
+
+    // called with m_mutex held
+    void Pipeline::complete(Reader& reader, const Completion& completion)
+    {
+        auto b = completion.buffer;
+        auto& f = *b->file;
+
+        if (completion.result == -EINTR || completion.result == -EAGAIN) {
+            reader.submit(f.fd, b);
+            return;
+        }
+
+        if (!f.failed && completion.result > 0) {
+            b->filled += static_cast<size_t>(completion.result);
+            if (b->filled < b->length) {
+                // short read, ask for the rest
+                b->iov.iov_base = b->data + b->filled;
+                b->iov.iov_len = b->length - b->filled;
+                reader.submit(f.fd, b);
+                return;
+            }
+        }
+
+        b->reading = false;
+        --f.inflight;
+        --m_inflight;
+
+        if (f.failed || completion.result <= 0) {
+            // error, or end of file before the size seen at open: the file changed
+            f.failed = true;
+            m_free.push_back(b);
+            return;
+        }
+
+        f.ready.emplace(b->offset, b);
+        schedule(f);
+    }
+
+    // called with m_mutex held
+    void Pipeline::schedule(File& file)
+    {
+        if (!file.hashing && !file.failed && file.ready.count(file.nextHash) != 0) {
+            file.hashing = true;
+            m_pool.submit([this, &file] { hash(file); });
+        }
+    }
+
+    /* Task consuming the ready chunks of file which follow what is already hashed.
+     **/
+    void Pipeline::hash(File& file)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;) {
+            auto it = file.ready.find(file.nextHash);
+            if (file.failed || it == file.ready.end()) {
+                break;
+            }
+            auto b = it->second;
+            file.ready.erase(it);
+
+            lock.unlock();
+            bool ok = m_consume(file.index, gsl::span<const uint8_t>(b->data, static_cast<std::ptrdiff_t>(b->length)));
+            if (ok && m_progress) {
+                m_progress(file.index, file.nextHash + b->length, file.size);
+            }
+            lock.lock();
+
+            file.nextHash += b->length;
+            file.failed = file.failed || !ok;
+            m_free.push_back(b);
+        }
+
+        file.hashing = false;
+        ++m_generation;
+        m_changed.notify_all();
+    }
+
+    /* Task reading a file which is not read by chunks in the pipeline.
+     **/
+    void Pipeline::stream(File& file)
+    {
+        uint64_t hashed = 0;
+        bool ok = readFile(m_paths[file.index], [this, &file, &hashed](gsl::span<const uint8_t> chunk) {
+            if (!m_consume(file.index, chunk)) {
+                return false;
+            }
+            hashed += static_cast<uint64_t>(chunk.size());
+            if (m_progress) {
+                m_progress(file.index, hashed, 0);
+            }
+            return true;
+        });
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        file.failed = !ok;
+        file.hashing = false;
+        ++m_generation;
+        m_changed.notify_all();
+    }
+
+    /* Reports and closes the files with nothing left to do, then opens the next ones.
+     * Called with m_mutex held through lock, released while done() runs; only this thread
+     * changes m_open. Returns false once every file is reported.
+     **/
+    bool Pipeline::retire(std::unique_lock<std::mutex>& lock)
+    {
+        for (auto it = m_open.begin(); it != m_open.end(); ) {
+            auto& f = **it;
+            const bool complete = f.failed || f.streamed || f.nextHash == f.size;
+            if (!complete || f.hashing || f.inflight > 0) {
+                ++it;
+                continue;
+            }
+
+            for (auto& chunk : f.ready) {
+                m_free.push_back(chunk.second);
+            }
+            if (f.fd >= 0) {
+                ::close(f.fd);
+            }
+
+            lock.unlock();
+            m_done(f.index, !f.failed);
+            lock.lock();
+
+            it = m_open.erase(it);
+        }
+
+        while (m_open.size() < m_filesInFlight && m_nextPath < m_paths.size()) {
+            std::unique_ptr<File> file(new File());
+            file->index = m_nextPath++;
+            lock.unlock();
+            m_opened(file->index);
+            lock.lock();
+            open(*file);
+            m_open.push_back(std::move(file));
+        }
+
+        return !m_open.empty();
+    }
+
+    // called with m_mutex held
+    bool Pipeline::anyHashing(void) const
+    {
+        return std::any_of(m_open.begin(), m_open.end(), [](const std::unique_ptr<File>& file) {
+            return file->hashing;
+        });
+    }
+
+    bool Pipeline::run(bool useIoUring)
+    {
+        std::unique_ptr<Reader> reader;
+        bool uring = false;
+
+#if defined(CRYPTO_HAVE_IO_URING)
+        if (useIoUring) {
+            std::unique_ptr<UringReader> r(new UringReader(static_cast<unsigned int>(m_readsPerFile * m_filesInFlight)));
+            if (r->valid()) {
+                reader = std::move(r);
+                uring = true;
+            }
+        }
+#else
+        (void) useIoUring;
+#endif
+        if (!reader) {
+            reader.reset(new PoolReader(std::min<size_t>(m_readsPerFile * m_filesInFlight, 16)));
+        }
+
+        if (!allocate(m_readsPerFile * m_filesInFlight)) {
+            for (size_t i = 0; i < m_paths.size(); ++i) {
+                m_done(i, false);
+            }
+            return uring;
+        }
+
+        // kept until the end, with the buffers it may still write to
+        std::unique_ptr<Reader> broken;
+
+        std::vector<Completion> completions;
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (retire(lock)) {
+            issue(*reader);
+
+            if (m_inflight > 0) {
+                // the hashing tasks go on meanwhile
+                lock.unlock();
+                completions.clear();
+                const bool working = reader->reap(completions, true);
+                lock.lock();
+
+                for (auto& completion : completions) {
+                    complete(*reader, completion);
+                }
+
+                if (!working) {
+                    // the files it was reading fail, the next ones are read by threads
+                    abandon();
+                    broken = std::move(reader);
+                    reader.reset(new PoolReader(std::min<size_t>(m_readsPerFile * m_filesInFlight, 16)));
+                    uring = false;
+                }
+            } else if (anyHashing()) {
+                // nothing to read until a task releases a buffer or completes a file
+                const auto generation = m_generation;
+                m_changed.wait(lock, [this, generation] { return m_generation != generation; });
+            }
+        }
+
+        return uring;
+    }
+
+} /* namespace */
+
+bool readFilesAsync(const std::vector<std::string>& paths,
+                    const std::function<void(size_t index)>& open,
+                    const std::function<bool(size_t index, gsl::span<const uint8_t> chunk)>& consume,
+                    const FileProgress& progress,
+                    const std::function<void(size_t index, bool ok)>& done,
+                    const AsyncHashOptions& options,
+                    ThreadPool& pool)
+{
+    Pipeline pipeline(paths, open, consume, progress, done, options, pool);
+    return pipeline.run(options.useIoUring);
+}
+
+} /* namespace file_detail */
+} /* namespace crypto */
@@ -0,0 +1,107 @@
+#include "Chunker.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace crypto {
+namespace chunk_detail {
+
+namespace {
+
+    // 256 random 64 bits values, from splitmix64; changing them moves every cut point
+    std::array<uint64_t, 256> makeGear(void)
+    {
+        std::array<uint64_t, 256> gear;
+        uint64_t seed = 0x6a09e667f3bcc908;
+        for (auto& value : gear) {
+            seed += 0x9e3779b97f4a7c15;
+            auto z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            value = z ^ (z >> 31);
+        }
+        return gear;
+    }
+
+    const std::array<uint64_t, 256> GEAR = makeGear();
+
+    // the bits highest bits, which depend on the last 64 bytes rolled in
+    uint64_t highMask(unsigned bits)
+    {
+        return bits == 0 ? 0 : ~uint64_t(0) << (64 - bits);
+    }
+
+    /* Rolls data[i, end) in, up to the first position where the bits of mask are all 0, and
+     * returns the index past it.
+     **/
+    inline size_t roll(const uint8_t* data, size_t i, size_t end, uint64_t& fingerprint, uint64_t mask, bool& cut)
+    {
+        for (; i < end; ++i) {
+            fingerprint = (fingerprint << 1) + GEAR[data[i]];
+            if (!(fingerprint & mask)) {
+                cut = true;
+                return i + 1;
+            }
+        }
+        return i;
+    }
+
+} /* namespace */
+
+GearScanner::GearScanner(const ChunkerOptions& options) :
+    m_length(0),
+    m_fingerprint(0)
+{
+    // an average of a power of two, at least 64 bytes, between the two bounds
+    unsigned bits = 6;
+    while ((size_t(1) << (bits + 1)) <= options.avgSize && bits < 40) {
+        ++bits;
+    }
+    m_avgSize = size_t(1) << bits;
+    m_minSize = std::min(options.minSize, m_avgSize);
+    m_maxSize = std::max(options.maxSize, m_avgSize);
+
+    m_maskS = highMask(bits + 2);
+    m_maskL = highMask(bits - 2);
+}
+
+size_t GearScanner::scan(const uint8_t* data, size_t size, bool& cut)
+{
+    auto fingerprint = m_fingerprint;
+    size_t i = 0;
+    cut = false;
+
+    // nothing can end before minSize, which is not even rolled in
+    if (m_length < m_minSize) {
+        i = std::min(size, m_minSize - m_length);
+    }
+
+    // harder to cut before the average size, easier after it, forced at the maximum
+    auto position = m_length + i;
+    if (position < m_avgSize) {
+        i = roll(data, i, std::min(size, i + (m_avgSize - position)), fingerprint, m_maskS, cut);
+    }
+    position = m_length + i;
+    if (!cut && position < m_maxSize) {
+        i = roll(data, i, std::min(size, i + (m_maxSize - position)), fingerprint, m_maskL, cut);
+    }
+    position = m_length + i;
+    cut = cut || position >= m_maxSize;
+
+    if (cut) {
+        reset();
+    } else {
+        m_length = position;
+        m_fingerprint = fingerprint;
+    }
+    return i;
+}
+
+void GearScanner::reset(void)
+{
+    m_length = 0;
+    m_fingerprint = 0;
+}
+
+} /* namespace chunk_detail */
+} /* namespace crypto */
@@ -0,0 +1,319 @@
+#include "DigestCache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crypto {
+
+    /* Layout of a slot in the index, in the byte order of the host: the index is a cache of
+     * the files of the machine, not meant to be moved.
+     **/
+    struct DigestCache::Slot
+    {
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        uint64_t mtimeNs;
+        uint64_t ctimeNs;
+        uint8_t algorithm;
+        uint8_t length;     // of the digest, 0 in an empty slot
+        uint8_t unused[6];
+        uint8_t digest[64];
+        uint64_t check;     // of the bytes above
+        uint64_t sequence;  // odd while the slot is written, see read()
+    };
+
+namespace {
+
+    static_assert(sizeof(DigestCache::Slot) == 128, "slots are two cache lines");
+
+    /* Header of the index:
+     *   4 bytes  magic "HDCI"
+     *   4 bytes  version
+     *   4 bytes  slot size
+     *   4 bytes  zero
+     *   8 bytes  number of slots, a power of two
+     * then zeroes up to HEADER_SIZE, followed by the slots.
+     **/
+    const char MAGIC[4] = { 'H', 'D', 'C', 'I' };
+    const uint32_t VERSION = 1;
+    const size_t HEADER_SIZE = 4096;
+
+    // slots looked at for a file before overwriting the first one
+    const size_t PROBES = 8;
+
+    // attempts at reading a slot being written before taking it for a miss
+    const size_t READ_ATTEMPTS = 4;
+
+    class IndexLock
+    {
+        public:
+            IndexLock(int fd, int operation) : m_fd(fd) { while (::flock(m_fd, operation) != 0 && errno == EINTR) {} }
+            ~IndexLock() { ::flock(m_fd, LOCK_UN); }
+
+            IndexLock(const IndexLock& other) = delete;
+            IndexLock& operator=(const IndexLock& other) = delete;
+
+        private:
+            int m_fd;
+    };
+
+    uint64_t nanoseconds(const struct timespec& ts)
+    {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    // FNV-1a
+    uint64_t checksum(const DigestCache::Slot& slot)
+    {
+        auto bytes = reinterpret_cast<const uint8_t*>(&slot);
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < offsetof(DigestCache::Slot, check); ++i) {
+            h = (h ^ bytes[i]) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    bool filled(const DigestCache::Slot& slot)
+    {
+        return slot.length != 0 && slot.check == checksum(slot);
+    }
+
+    /* Copies slot without any lock, as a seqlock reader: the writers, which exclude each
+     * other, make its sequence odd while they change it. Returns false when the copy may be
+     * torn, slot being written meanwhile.
+     **/
+    bool read(const DigestCache::Slot& slot, DigestCache::Slot& copy)
+    {
+        for (size_t attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+            const auto before = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+            if (before % 2 != 0) {
+                continue;
+            }
+            std::memcpy(&copy, &slot, offsetof(DigestCache::Slot, sequence));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // overwrites slot with entry, the caller holding the exclusive locks of the writers
+    void write(DigestCache::Slot& slot, const DigestCache::Slot& entry)
+    {
+        const auto sequence = __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot.sequence, sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        std::memcpy(&slot, &entry, offsetof(DigestCache::Slot, sequence));
+        __atomic_store_n(&slot.sequence, sequence + 2, __ATOMIC_RELEASE);
+    }
+
+    // splitmix64 finalizer
+    uint64_t mix(uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    size_t roundUpPowerOfTwo(size_t n)
+    {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+} /* namespace */
+
+bool FileKey::of(const std::string& path, FileKey& key)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    key.device = static_cast<uint64_t>(st.st_dev);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+    key.size = static_cast<uint64_t>(st.st_size);
+    key.mtimeNs = nanoseconds(st.st_mtim);
+    key.ctimeNs = nanoseconds(st.st_ctim);
+    return true;
+}
+
+bool FileKey::operator==(const FileKey& other) const
+{
+    return device == other.device && inode == other.inode && size == other.size &&
+           mtimeNs == other.mtimeNs && ctimeNs == other.ctimeNs;
+}
+
+DigestCache::DigestCache(const std::string& indexPath, const DigestCacheOptions& options) :
+    m_racyWindowNs(options.racyWindowNs),
+    m_fd(::open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)),
+    m_map(MAP_FAILED),
+    m_mapSize(0),
+    m_slots(nullptr),
+    m_mask(0)
+{
+    if (m_fd < 0) {
+        return;
+    }
+
+    // the first process to get the lock initializes an empty index
+    IndexLock lock(m_fd, LOCK_EX);
+
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0) {
+        return;
+    }
+
+    uint8_t header[HEADER_SIZE] = {};
+    if (st.st_size != 0 && ::pread(m_fd, header, HEADER_SIZE, 0) != static_cast<ssize_t>(HEADER_SIZE)) {
+        return;
+    }
+
+    /* The file is sized before its header is written: one left without a header by a crash
+     * in between is initialized again, as an empty one is.
+     **/
+    const bool uninitialized = std::all_of(header, header + sizeof(MAGIC), [](uint8_t b) { return b == 0; });
+
+    uint64_t slots = 0;
+    if (uninitialized) {
+        slots = roundUpPowerOfTwo(options.slots > 0 ? options.slots : 1);
+        const uint32_t slotSize = sizeof(Slot);
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        std::memcpy(header + 4, &VERSION, sizeof(VERSION));
+        std::memcpy(header + 8, &slotSize, sizeof(slotSize));
+        std::memcpy(header + 16, &slots, sizeof(slots));
+
+        // the slots are a hole, read as zeroes, i.e. empty
+        if (::ftruncate(m_fd, 0) != 0 ||
+            ::ftruncate(m_fd, static_cast<off_t>(HEADER_SIZE + slots * sizeof(Slot))) != 0 ||
+            ::pwrite(m_fd, header, HEADER_SIZE, 0) != static_cast<ssize_t>(HEADER_SIZE)) {
+            return;
+        }
+    } else {
+        uint32_t version = 0;
+        uint32_t slotSize = 0;
+        std::memcpy(&version, header + 4, sizeof(version));
+        std::memcpy(&slotSize, header + 8, sizeof(slotSize));
+        std::memcpy(&slots, header + 16, sizeof(slots));
+        if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION || slotSize != sizeof(Slot) ||
+            slots == 0 || (slots & (slots - 1)) != 0 ||
+            static_cast<uint64_t>(st.st_size) < HEADER_SIZE + slots * sizeof(Slot)) {
+            return;
+        }
+    }
+
+    m_mapSize = HEADER_SIZE + slots * sizeof(Slot);
+    m_map = ::mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_map == MAP_FAILED) {
+        return;
+    }
+    m_slots = reinterpret_cast<Slot*>(static_cast<uint8_t*>(m_map) + HEADER_SIZE);
+    m_mask = slots - 1;
+}
+
+DigestCache::~DigestCache()
+{
+    if (m_map != MAP_FAILED) {
+        ::munmap(m_map, m_mapSize);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+size_t DigestCache::home(const FileKey& key, HashAlgorithm algorithm) const
+{
+    return static_cast<size_t>(mix(key.device ^ mix(key.inode ^ (static_cast<uint64_t>(algorithm) << 56))));
+}
+
+DigestCache::Slot* DigestCache::probe(const FileKey& key, HashAlgorithm algorithm)
+{
+    const auto home = this->home(key, algorithm);
+    Slot* empty = nullptr;
+    for (size_t i = 0; i < PROBES; ++i) {
+        auto& slot = m_slots[(home + i) & m_mask];
+        if (!filled(slot)) {
+            if (empty == nullptr) {
+                empty = &slot;
+            }
+            continue;
+        }
+        if (slot.device == key.device && slot.inode == key.inode && slot.algorithm == static_cast<uint8_t>(algorithm)) {
+            return &slot;
+        }
+    }
+
+    return empty != nullptr ? empty : &m_slots[home & m_mask];
+}
+
+bool DigestCache::lookup(const FileKey& key, HashAlgorithm algorithm, gsl::span<uint8_t> digest)
+{
+    if (!valid() || algorithm == HashAlgorithm::UNKNOWN) {
+        return false;
+    }
+
+    // no lock: the slots are copied as a seqlock reader would, then checked
+    const auto home = this->home(key, algorithm);
+    for (size_t i = 0; i < PROBES; ++i) {
+        Slot slot;
+        if (!read(m_slots[(home + i) & m_mask], slot) || !filled(slot) ||
+            slot.device != key.device || slot.inode != key.inode || slot.algorithm != static_cast<uint8_t>(algorithm)) {
+            continue;
+        }
+        if (slot.size != key.size || slot.mtimeNs != key.mtimeNs || slot.ctimeNs != key.ctimeNs ||
+            slot.length != static_cast<size_t>(digest.size())) {
+            return false;
+        }
+        std::memcpy(digest.data(), slot.digest, slot.length);
+        return true;
+    }
+    return false;
+}
+
+void DigestCache::store(const FileKey& key, HashAlgorithm algorithm, gsl::span<const uint8_t> digest)
+{
+    if (!valid() || algorithm == HashAlgorithm::UNKNOWN || digest.size() == 0 ||
+        static_cast<size_t>(digest.size()) > sizeof(Slot::digest)) {
+        return;
+    }
+
+    struct timespec now;
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    const auto changed = std::max(key.mtimeNs, key.ctimeNs);
+    if (changed + m_racyWindowNs > nanoseconds(now)) {
+        return;
+    }
+
+    Slot entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.device = key.device;
+    entry.inode = key.inode;
+    entry.size = key.size;
+    entry.mtimeNs = key.mtimeNs;
+    entry.ctimeNs = key.ctimeNs;
+    entry.algorithm = static_cast<uint8_t>(algorithm);
+    entry.length = static_cast<uint8_t>(digest.size());
+    std::memcpy(entry.digest, digest.data(), static_cast<size_t>(digest.size()));
+    entry.check = checksum(entry);
+
+    // flock() does not exclude the threads sharing the descriptor
+    std::lock_guard<std::mutex> guard(m_mutex);
+    IndexLock lock(m_fd, LOCK_EX);
+    write(*probe(key, algorithm), entry);
+}
+
+} /* namespace crypto */
@@ -0,0 +1,340 @@
+#include "Dispatch.hpp"
+#include "MD4.hpp"
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA256224.hpp"
+#include "SHA512384.hpp"
+#include "MD4Kernel.hpp"
+#include "MD5Kernel.hpp"
+#include "SHA1Kernel.hpp"
+#include "SHA256224Kernel.hpp"
+#include "SHA512384Kernel.hpp"
+#include "cpuid.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+
+namespace crypto {
+namespace dispatch {
+
+namespace {
+
+template <typename Word>
+struct Kernel
+{
+    const char* name;
+    BlockKernel<Word> compress;
+    bool (*supported)(void);
+};
+
+bool always(void)
+{
+    return true;
+}
+
+template <size_t N>
+std::array<uint32_t, N>& words(uint32_t* state)
+{
+    return *reinterpret_cast<std::array<uint32_t, N>*>(state);
+}
+
+void md4Portable(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    md4_detail::compress(words<4>(state), blocks, nblocks);
+}
+
+void md5Portable(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    md5_detail::compress(words<4>(state), blocks, nblocks);
+}
+
+void sha1Portable(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    sha1_detail::compress(words<5>(state), blocks, nblocks);
+}
+
+// the scalar rounds fed by the vectorized message expansions
+void sha1SSSE3(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    alignas(16) uint32_t wk[80];
+    for (; nblocks > 0; --nblocks, blocks += 64) {
+        sha1_detail::expandSSSE3(blocks, wk);
+        sha1_detail::compressExpanded(words<5>(state), wk);
+    }
+}
+
+void sha1AVX2(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    alignas(32) uint32_t wk[2][80];
+    for (; nblocks >= 2; nblocks -= 2, blocks += 128) {
+        sha1_detail::expandAVX2(blocks, wk[0], wk[1]);
+        sha1_detail::compressExpanded(words<5>(state), wk[0]);
+        sha1_detail::compressExpanded(words<5>(state), wk[1]);
+    }
+    if (nblocks > 0) {
+        sha1SSSE3(state, blocks, nblocks);
+    }
+}
+
+void sha256Portable(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    sha256224_detail::compress(words<8>(state), blocks, nblocks);
+}
+
+void sha512Portable(uint64_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    sha512384_detail::compress(*reinterpret_cast<std::array<uint64_t, 8>*>(state), blocks, nblocks);
+}
+
+bool sha1AVX2Supported(void)
+{
+    // the odd block of a run goes through the SSSE3 expansion
+    return sha1_detail::hasAVX2() && sha1_detail::hasSSSE3();
+}
+
+// Candidate kernels of every algorithm, best first; the last one always runs
+const Kernel<uint32_t> MD4_KERNELS[] = {
+    { "portable", md4Portable, always }
+};
+
+const Kernel<uint32_t> MD5_KERNELS[] = {
+    { "portable", md5Portable, always }
+};
+
+const Kernel<uint32_t> SHA1_KERNELS[] = {
+    { "shani", sha1_detail::processBlocksSHANI, sha1_detail::hasSHANI },
+    { "avx2", sha1AVX2, sha1AVX2Supported },
+    { "ssse3", sha1SSSE3, sha1_detail::hasSSSE3 },
+    { "portable", sha1Portable, always }
+};
+
+const Kernel<uint32_t> SHA256_KERNELS[] = {
+    { "shani", sha256224_detail::processBlocksSHANI, sha256224_detail::hasSHANI },
+    { "portable", sha256Portable, always }
+};
+
+const Kernel<uint64_t> SHA512_KERNELS[] = {
+    { "avx2", sha512384_detail::processBlocksAVX2, sha512384_detail::hasAVX2 },
+    { "portable", sha512Portable, always }
+};
+
+/* The kernels of one algorithm and the one currently bound. Hashers only read the
+ * binding, a relaxed load is enough: every kernel gives the same result.
+ **/
+template <typename Word>
+struct Slot
+{
+    const char* algo;
+    const Kernel<Word>* kernels;
+    size_t count;
+    std::atomic<const Kernel<Word>*> bound;
+
+    template <size_t N>
+    Slot(const char* name, const Kernel<Word> (&table)[N]) :
+        algo(name), kernels(table), count(N), bound(best())
+    {
+    }
+
+    const Kernel<Word>* best(void) const
+    {
+        for (size_t i = 0; i < count; ++i) {
+            if (kernels[i].supported()) {
+                return &kernels[i];
+            }
+        }
+        return &kernels[count - 1];
+    }
+
+    bool bind(const std::string& name)
+    {
+        if (name == "auto") {
+            bound.store(best(), std::memory_order_relaxed);
+            return true;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (name == kernels[i].name && kernels[i].supported()) {
+                bound.store(&kernels[i], std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::string> available(void) const
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < count; ++i) {
+            if (kernels[i].supported()) {
+                names.emplace_back(kernels[i].name);
+            }
+        }
+        return names;
+    }
+
+    BlockKernel<Word> get(void) const
+    {
+        return bound.load(std::memory_order_relaxed)->compress;
+    }
+};
+
+struct Registry
+{
+    Slot<uint32_t> md4 { "MD4", MD4_KERNELS };
+    Slot<uint32_t> md5 { "MD5", MD5_KERNELS };
+    Slot<uint32_t> sha1 { "SHA1", SHA1_KERNELS };
+    Slot<uint32_t> sha256 { "SHA256", SHA256_KERNELS };
+    Slot<uint64_t> sha512 { "SHA512", SHA512_KERNELS };
+
+    Registry();
+
+    // f(slot) on the slot of algo, false for HashAlgorithm::UNKNOWN
+    template <typename F>
+    bool visit(HashAlgorithm algo, F f)
+    {
+        switch (algo) {
+            case HashAlgorithm::MD4:    f(md4); return true;
+            case HashAlgorithm::MD5:    f(md5); return true;
+            case HashAlgorithm::SHA1:   f(sha1); return true;
+            case HashAlgorithm::SHA224:
+            case HashAlgorithm::SHA256: f(sha256); return true;
+            case HashAlgorithm::SHA384:
+            case HashAlgorithm::SHA512: f(sha512); return true;
+            default:                    return false;
+        }
+    }
+
+    template <typename F>
+    void each(F f)
+    {
+        f(md4);
+        f(md5);
+        f(sha1);
+        f(sha256);
+        f(sha512);
+    }
+};
+
+// algorithm of a name of CRYPTO_KERNEL, HashAlgorithm::UNKNOWN for the others
+HashAlgorithm algorithmNamed(const std::string& name)
+{
+    static const struct { const char* name; HashAlgorithm algo; } NAMES[] = {
+        { "MD4", HashAlgorithm::MD4 },
+        { "MD5", HashAlgorithm::MD5 },
+        { "SHA1", HashAlgorithm::SHA1 },
+        { "SHA224", HashAlgorithm::SHA224 },
+        { "SHA256", HashAlgorithm::SHA256 },
+        { "SHA384", HashAlgorithm::SHA384 },
+        { "SHA512", HashAlgorithm::SHA512 },
+    };
+    for (const auto& n : NAMES) {
+        if (name == n.name) {
+            return n.algo;
+        }
+    }
+    return HashAlgorithm::UNKNOWN;
+}
+
+/* Applies the CRYPTO_KERNEL overrides on top of the best kernels.
+ **/
+Registry::Registry()
+{
+    const char* env = std::getenv("CRYPTO_KERNEL");
+    if (env == nullptr) {
+        return;
+    }
+
+    std::stringstream entries(env);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        const auto eq = entry.find('=');
+        if (eq == std::string::npos) {
+            each([&entry](auto& slot) { slot.bind(entry); });
+            continue;
+        }
+
+        // SHA224 and SHA384 bind the slots they share, as force() does
+        const auto kernel = entry.substr(eq + 1);
+        visit(algorithmNamed(entry.substr(0, eq)), [&kernel](auto& slot) { slot.bind(kernel); });
+    }
+}
+
+Registry& registry(void)
+{
+    static Registry r;
+    return r;
+}
+
+// resolved when the library is loaded rather than by the first hasher
+const Registry& loaded = registry();
+
+} /* anonymous namespace */
+
+const char* selected(HashAlgorithm algo)
+{
+    const char* name = nullptr;
+    registry().visit(algo, [&name](auto& slot) { name = slot.bound.load(std::memory_order_relaxed)->name; });
+    return name;
+}
+
+std::vector<std::string> available(HashAlgorithm algo)
+{
+    std::vector<std::string> names;
+    registry().visit(algo, [&names](auto& slot) { names = slot.available(); });
+    return names;
+}
+
+bool force(HashAlgorithm algo, const std::string& kernel)
+{
+    bool bound = false;
+    registry().visit(algo, [&bound, &kernel](auto& slot) { bound = slot.bind(kernel); });
+    return bound;
+}
+
+std::string describe(void)
+{
+    const auto& f = cpuid::features();
+    std::stringstream ss;
+
+    ss << "cpu:";
+    if (f.ssse3)   ss << " ssse3";
+    if (f.sse41)   ss << " sse4.1";
+    if (f.avx2)    ss << " avx2";
+    if (f.avx512f) ss << " avx512f";
+    if (f.sha)     ss << " sha";
+    ss << ';';
+
+    registry().each([&ss](auto& slot) {
+        ss << ' ' << slot.algo << '=' << slot.bound.load(std::memory_order_relaxed)->name;
+    });
+
+    return ss.str();
+}
+
+BlockKernel<uint32_t> md4(void)
+{
+    return registry().md4.get();
+}
+
+BlockKernel<uint32_t> md5(void)
+{
+    return registry().md5.get();
+}
+
+BlockKernel<uint32_t> sha1(void)
+{
+    return registry().sha1.get();
+}
+
+BlockKernel<uint32_t> sha256(void)
+{
+    return registry().sha256.get();
+}
+
+BlockKernel<uint64_t> sha512(void)
+{
+    return registry().sha512.get();
+}
+
+} /* namespace dispatch */
+} /* namespace crypto */
@@ -0,0 +1,137 @@
+#include "HashFile.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crypto {
+namespace file_detail {
+
+static const size_t READ_BUFFER_SIZE = 1 << 20;
+static const size_t READ_BUFFER_ALIGNMENT = 4096;
+
+namespace {
+
+    class FileDescriptor
+    {
+        public:
+            explicit FileDescriptor(int fd) : m_fd(fd) {}
+            ~FileDescriptor() { if (m_fd >= 0) ::close(m_fd); }
+
+            FileDescriptor(const FileDescriptor& other) = delete;
+            FileDescriptor& operator=(const FileDescriptor& other) = delete;
+
+            int get(void) const { return m_fd; }
+
+        private:
+            int m_fd;
+    };
+
+    class Mapping
+    {
+        public:
+            Mapping(int fd, size_t size) :
+                m_addr(::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)),
+                m_size(size)
+            {}
+            ~Mapping() { if (m_addr != MAP_FAILED) ::munmap(m_addr, m_size); }
+
+            Mapping(const Mapping& other) = delete;
+            Mapping& operator=(const Mapping& other) = delete;
+
+            bool valid(void) const { return m_addr != MAP_FAILED; }
+            void* data(void) const { return m_addr; }
+
+        private:
+            void* m_addr;
+            size_t m_size;
+    };
+
+    struct FreeDeleter
+    {
+        void operator()(void* p) const { std::free(p); }
+    };
+
+} /* namespace */
+
+static bool consumeMapping(const Mapping& mapping, size_t size, const std::function<bool(gsl::span<const uint8_t>)>& consume)
+{
+    // Advice only, a kernel without huge page cache support ignores the second one
+    ::madvise(mapping.data(), size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(mapping.data(), size, MADV_HUGEPAGE);
+#endif
+
+    return consume(gsl::span<const uint8_t>(static_cast<const uint8_t*>(mapping.data()), static_cast<std::ptrdiff_t>(size)));
+}
+
+static bool streamFile(int fd, const std::function<bool(gsl::span<const uint8_t>)>& consume)
+{
+    void* p = nullptr;
+    if (::posix_memalign(&p, READ_BUFFER_ALIGNMENT, READ_BUFFER_SIZE) != 0) {
+        return false;
+    }
+    std::unique_ptr<uint8_t, FreeDeleter> buffer(static_cast<uint8_t*>(p));
+
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    bool seekable = true;
+    off_t offset = 0;
+    for (;;) {
+        auto n = seekable ?
+            ::pread(fd, buffer.get(), READ_BUFFER_SIZE, offset) :
+            ::read(fd, buffer.get(), READ_BUFFER_SIZE);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ESPIPE && seekable) {
+                seekable = false;
+                continue;
+            }
+            return false;
+        }
+
+        if (n == 0) {
+            return true;
+        }
+
+        offset += n;
+        if (!consume(gsl::span<const uint8_t>(buffer.get(), n))) {
+            return false;
+        }
+    }
+}
+
+bool readFile(const std::string& path, const std::function<bool(gsl::span<const uint8_t>)>& consume)
+{
+    FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd.get(), &st) != 0) {
+        return false;
+    }
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        auto size = static_cast<size_t>(st.st_size);
+        Mapping mapping(fd.get(), size);
+        if (mapping.valid()) {
+            return consumeMapping(mapping, size, consume);
+        }
+        // some filesystems cannot be mapped, read them instead
+    }
+
+    return streamFile(fd.get(), consume);
+}
+
+} /* namespace file_detail */
+} /* namespace crypto */
@@ -0,0 +1,137 @@
+#include "Hex.hpp"
+
+#include <cstring>
+
+namespace crypto {
+namespace hex_detail {
+
+static const char DIGITS[] = "0123456789abcdef";
+
+void encode(const uint8_t* in, size_t n, char* out)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = DIGITS[in[i] >> 4];
+        out[2 * i + 1] = DIGITS[in[i] & 0x0f];
+    }
+}
+
+// value of the hexadecimal digit c, or a value above 15
+static inline unsigned digit(char c)
+{
+    unsigned d = static_cast<uint8_t>(c) - '0';
+    unsigned l = (static_cast<uint8_t>(c) | 0x20) - 'a';
+    return d <= 9 ? d : (l <= 5 ? l + 10 : 16);
+}
+
+bool decode(const char* in, size_t n, uint8_t* out)
+{
+    unsigned invalid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto hi = digit(in[2 * i]);
+        auto lo = digit(in[2 * i + 1]);
+        invalid |= (hi | lo) & ~0x0fu;
+        out[i] = static_cast<uint8_t>((hi << 4) | (lo & 0x0f));
+    }
+    return invalid == 0;
+}
+
+/* AVX2 takes the whole 32-byte vectors, SSSE3 a 16-byte one left after them, the portable
+ * code the last bytes: a MD5 digest is one SSSE3 vector, a SHA-1 one a vector and 4 bytes.
+ **/
+void encode(Kernel widest, const uint8_t* in, size_t n, char* out)
+{
+    size_t done = 0;
+    if (widest == Kernel::AVX2 && n >= 32) {
+        done = n - n % 32;
+        encodeAVX2(in, done, out);
+    }
+    if (widest != Kernel::PORTABLE && n - done >= 16) {
+        const auto vectors = (n - done) - (n - done) % 16;
+        encodeSSSE3(in + done, vectors, out + 2 * done);
+        done += vectors;
+    }
+    encode(in + done, n - done, out + 2 * done);
+}
+
+bool decode(Kernel widest, const char* in, size_t n, uint8_t* out)
+{
+    size_t done = 0;
+    bool valid = true;
+    if (widest == Kernel::AVX2 && n >= 32) {
+        done = n - n % 32;
+        valid = decodeAVX2(in, done, out);
+    }
+    if (widest != Kernel::PORTABLE && n - done >= 16) {
+        const auto vectors = (n - done) - (n - done) % 16;
+        valid = decodeSSSE3(in + 2 * done, vectors, out + done) && valid;
+        done += vectors;
+    }
+    return decode(in + 2 * done, n - done, out + done) && valid;
+}
+
+Kernel widest(void)
+{
+    // the AVX2 hosts all have SSSE3, which takes the vector left after the AVX2 ones
+    static const Kernel selected = (hasAVX2() && hasSSSE3()) ? Kernel::AVX2 :
+                                   hasSSSE3()               ? Kernel::SSSE3 :
+                                                              Kernel::PORTABLE;
+    return selected;
+}
+
+} /* namespace hex_detail */
+
+namespace {
+
+    inline void barrier(uint64_t& value)
+    {
+#if defined(__GNUC__)
+        __asm__ volatile("" : "+r"(value));
+#else
+        volatile uint64_t sink = value;
+        value = sink;
+#endif
+    }
+
+} /* namespace */
+
+void toHex(gsl::span<const uint8_t> bytes, char* out)
+{
+    hex_detail::encode(hex_detail::widest(), bytes.data(), static_cast<size_t>(bytes.size()), out);
+}
+
+bool fromHex(gsl::span<const char> text, uint8_t* out)
+{
+    if (text.size() % 2 != 0) {
+        return false;
+    }
+
+    return hex_detail::decode(hex_detail::widest(), text.data(), static_cast<size_t>(text.size()) / 2, out);
+}
+
+bool equals(gsl::span<const uint8_t> a, gsl::span<const uint8_t> b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    const auto n = static_cast<size_t>(a.size());
+
+    // no early exit: every word is looked at whatever the first difference, the barrier
+    // keeps the compiler from turning the accumulation back into a comparison loop
+    uint64_t diff = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+        uint64_t x, y;
+        std::memcpy(&x, a.data() + i, sizeof(x));
+        std::memcpy(&y, b.data() + i, sizeof(y));
+        diff |= x ^ y;
+        barrier(diff);
+    }
+    for (; i < n; ++i) {
+        diff |= a[i] ^ b[i];
+        barrier(diff);
+    }
+    return diff == 0;
+}
+
+} /* namespace crypto */
@@ -0,0 +1,91 @@
+#include "Hex.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace hex_detail {
+
+#if defined(__AVX2__)
+
+bool hasAVX2(void)
+{
+    return cpuid::features().avx2;
+}
+
+void encodeAVX2(const uint8_t* in, size_t n, char* out)
+{
+    const __m256i DIGITS = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i LOW = _mm256_set1_epi8(0x0f);
+
+    for (size_t i = 0; i < n; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        auto hi = _mm256_shuffle_epi8(DIGITS, _mm256_and_si256(_mm256_srli_epi16(x, 4), LOW));
+        auto lo = _mm256_shuffle_epi8(DIGITS, _mm256_and_si256(x, LOW));
+        // the unpacks work within 128 bits lanes: bytes 0-7 | 16-23 and 8-15 | 24-31
+        auto first = _mm256_unpacklo_epi8(hi, lo);
+        auto second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+}
+
+// digit values of 32 characters, valid lanes of which are set to 0xff
+static inline __m256i digits(__m256i c, __m256i& valid)
+{
+    auto d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    auto l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    auto isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    auto isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+    valid = _mm256_or_si256(isDigit, isLetter);
+    return _mm256_blendv_epi8(_mm256_add_epi8(l, _mm256_set1_epi8(10)), d, isDigit);
+}
+
+bool decodeAVX2(const char* in, size_t n, uint8_t* out)
+{
+    // (high digit) * 16 + (low digit) for every pair of characters
+    const __m256i WEIGHTS = _mm256_set1_epi16(0x0110);
+
+    auto valid = _mm256_set1_epi8(-1);
+    for (size_t i = 0; i < n; i += 32) {
+        __m256i valid0, valid1;
+        auto v0 = digits(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid0);
+        auto v1 = digits(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid1);
+        valid = _mm256_and_si256(valid, _mm256_and_si256(valid0, valid1));
+        // the pack interleaves the 64 bits quarters of both inputs, put them back in order
+        auto bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, WEIGHTS), _mm256_maddubs_epi16(v1, WEIGHTS));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return _mm256_movemask_epi8(valid) == -1;
+}
+
+#else
+
+bool hasAVX2(void)
+{
+    return false;
+}
+
+void encodeAVX2(const uint8_t*, size_t, char*)
+{
+    // never selected: hasAVX2() is false when the kernel is not compiled in
+    assert(false);
+}
+
+bool decodeAVX2(const char*, size_t, uint8_t*)
+{
+    assert(false);
+    return false;
+}
+
+#endif
+
+} /* namespace hex_detail */
+} /* namespace crypto */
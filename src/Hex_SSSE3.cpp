@@ -0,0 +1,86 @@
+#include "Hex.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace hex_detail {
+
+#if defined(__SSSE3__)
+
+bool hasSSSE3(void)
+{
+    return cpuid::features().ssse3;
+}
+
+void encodeSSSE3(const uint8_t* in, size_t n, char* out)
+{
+    const __m128i DIGITS = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i LOW = _mm_set1_epi8(0x0f);
+
+    for (size_t i = 0; i < n; i += 16) {
+        auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        auto hi = _mm_shuffle_epi8(DIGITS, _mm_and_si128(_mm_srli_epi16(x, 4), LOW));
+        auto lo = _mm_shuffle_epi8(DIGITS, _mm_and_si128(x, LOW));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+}
+
+// digit values of 16 characters, valid lanes of which are set to 0xff
+static inline __m128i digits(__m128i c, __m128i& valid)
+{
+    auto d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    auto l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    auto isDigit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    auto isLetter = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+    valid = _mm_or_si128(isDigit, isLetter);
+    return _mm_or_si128(_mm_and_si128(isDigit, d),
+                        _mm_and_si128(isLetter, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+bool decodeSSSE3(const char* in, size_t n, uint8_t* out)
+{
+    // (high digit) * 16 + (low digit) for every pair of characters
+    const __m128i WEIGHTS = _mm_set1_epi16(0x0110);
+
+    auto valid = _mm_set1_epi8(-1);
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i valid0, valid1;
+        auto v0 = digits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), valid0);
+        auto v1 = digits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), valid1);
+        valid = _mm_and_si128(valid, _mm_and_si128(valid0, valid1));
+        auto bytes = _mm_packus_epi16(_mm_maddubs_epi16(v0, WEIGHTS), _mm_maddubs_epi16(v1, WEIGHTS));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    return _mm_movemask_epi8(valid) == 0xffff;
+}
+
+#else
+
+bool hasSSSE3(void)
+{
+    return false;
+}
+
+void encodeSSSE3(const uint8_t*, size_t, char*)
+{
+    // never selected: hasSSSE3() is false when the kernel is not compiled in
+    assert(false);
+}
+
+bool decodeSSSE3(const char*, size_t, uint8_t*)
+{
+    assert(false);
+    return false;
+}
+
+#endif
+
+} /* namespace hex_detail */
+} /* namespace crypto */
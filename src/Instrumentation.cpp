@@ -0,0 +1,334 @@
+#include "Instrumentation.hpp"
+#include "HashingStrategy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace crypto {
+namespace {
+
+    const size_t ALGORITHMS = static_cast<size_t>(HashAlgorithm::SHA512) + 1;
+
+    // log-linear buckets: values below SUB are exact, then SUB buckets per power of two
+    const unsigned SUB_BITS = 3;
+    const uint64_t SUB = 1 << SUB_BITS;
+    const unsigned MAGNITUDES = 40;     // up to 2^42 ns, about 73 minutes
+    const size_t BUCKETS = (MAGNITUDES + 1) * SUB;
+
+    size_t bucketOf(uint64_t value)
+    {
+        if (value < SUB) {
+            return static_cast<size_t>(value);
+        }
+        unsigned magnitude = 63 - __builtin_clzll(value);
+        auto sub = (value >> (magnitude - SUB_BITS)) & (SUB - 1);
+        return std::min(static_cast<size_t>((magnitude - SUB_BITS + 1) * SUB + sub), BUCKETS - 1);
+    }
+
+    uint64_t lowestOf(size_t bucket)
+    {
+        if (bucket < SUB) {
+            return bucket;
+        }
+        unsigned magnitude = static_cast<unsigned>(bucket / SUB) + SUB_BITS - 1;
+        return (SUB + bucket % SUB) << (magnitude - SUB_BITS);
+    }
+
+    /* Only the owning thread writes, with a load and a store which compile to plain moves;
+     * the atomics just make the concurrent reads of snapshot() well defined.
+     **/
+    inline void add(std::atomic<uint64_t>& counter, uint64_t n)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    struct Histogram
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        std::atomic<uint64_t> buckets[BUCKETS];
+
+        void record(uint64_t value)
+        {
+            add(count, 1);
+            add(sum, value);
+            if (value > max.load(std::memory_order_relaxed)) {
+                max.store(value, std::memory_order_relaxed);
+            }
+            add(buckets[bucketOf(value)], 1);
+        }
+    };
+
+    struct Stats
+    {
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> blocks;
+        std::atomic<uint64_t> partialCopies;
+        std::atomic<uint64_t> updates;
+        std::atomic<uint64_t> getHashes;
+        Histogram updateLatency;
+        Histogram getHashLatency;
+    };
+
+    struct ThreadStats
+    {
+        Stats algorithms[ALGORITHMS];
+
+        ThreadStats(void) { clear(); }
+
+        void clear(void)
+        {
+            for (auto& stats : algorithms) {
+                for (auto counter : { &stats.bytes, &stats.blocks, &stats.partialCopies, &stats.updates, &stats.getHashes }) {
+                    counter->store(0, std::memory_order_relaxed);
+                }
+                for (auto histogram : { &stats.updateLatency, &stats.getHashLatency }) {
+                    histogram->count.store(0, std::memory_order_relaxed);
+                    histogram->sum.store(0, std::memory_order_relaxed);
+                    histogram->max.store(0, std::memory_order_relaxed);
+                    for (auto& bucket : histogram->buckets) {
+                        bucket.store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    };
+
+    void mergeHistogram(Histogram& into, const Histogram& from)
+    {
+        add(into.count, from.count.load(std::memory_order_relaxed));
+        add(into.sum, from.sum.load(std::memory_order_relaxed));
+        into.max.store(std::max(into.max.load(std::memory_order_relaxed), from.max.load(std::memory_order_relaxed)),
+                       std::memory_order_relaxed);
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            add(into.buckets[i], from.buckets[i].load(std::memory_order_relaxed));
+        }
+    }
+
+    void merge(ThreadStats& into, const ThreadStats& from)
+    {
+        for (size_t a = 0; a < ALGORITHMS; ++a) {
+            auto& to = into.algorithms[a];
+            const auto& stats = from.algorithms[a];
+            add(to.bytes, stats.bytes.load(std::memory_order_relaxed));
+            add(to.blocks, stats.blocks.load(std::memory_order_relaxed));
+            add(to.partialCopies, stats.partialCopies.load(std::memory_order_relaxed));
+            add(to.updates, stats.updates.load(std::memory_order_relaxed));
+            add(to.getHashes, stats.getHashes.load(std::memory_order_relaxed));
+            mergeHistogram(to.updateLatency, stats.updateLatency);
+            mergeHistogram(to.getHashLatency, stats.getHashLatency);
+        }
+    }
+
+    /* Statistics of the live threads, and the sum of the ones of the threads gone. Never
+     * destroyed, as threads may still exit while the process terminates.
+     **/
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<ThreadStats*> live;
+        ThreadStats retired;
+    };
+
+    Registry& registry(void)
+    {
+        static auto instance = new Registry();
+        return *instance;
+    }
+
+    class Local
+    {
+        public:
+
+            Local(void) : m_stats(new ThreadStats())
+            {
+                auto& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.live.push_back(m_stats.get());
+            }
+
+            ~Local()
+            {
+                auto& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                merge(r.retired, *m_stats);
+                r.live.erase(std::find(r.live.begin(), r.live.end(), m_stats.get()));
+            }
+
+            Stats& of(HashAlgorithm algorithm)
+            {
+                auto index = static_cast<size_t>(algorithm);
+                return m_stats->algorithms[index < ALGORITHMS ? index : 0];
+            }
+
+        private:
+
+            std::unique_ptr<ThreadStats> m_stats;
+    };
+
+    Stats& local(HashAlgorithm algorithm)
+    {
+        thread_local Local stats;
+        return stats.of(algorithm);
+    }
+
+    instrumentation::HistogramSnapshot snapshotOf(const Histogram& histogram)
+    {
+        instrumentation::HistogramSnapshot result;
+        result.count = histogram.count.load(std::memory_order_relaxed);
+        result.sum = histogram.sum.load(std::memory_order_relaxed);
+        result.max = histogram.max.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            auto n = histogram.buckets[i].load(std::memory_order_relaxed);
+            if (n > 0) {
+                result.buckets.emplace_back(lowestOf(i), n);
+            }
+        }
+        return result;
+    }
+
+    uint64_t now(void)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // the first call of a thread is sampled, then one in LATENCY_SAMPLING
+    inline uint64_t begin(unsigned& countdown)
+    {
+        if (countdown-- > 0) {
+            return 0;
+        }
+        countdown = instrumentation::LATENCY_SAMPLING - 1;
+        // 0 means "not sampled"
+        return std::max<uint64_t>(now(), 1);
+    }
+
+    thread_local unsigned t_updateCountdown = 0;
+    thread_local unsigned t_getHashCountdown = 0;
+
+} /* namespace */
+
+namespace instrumentation {
+
+uint64_t HistogramSnapshot::percentile(double q) const
+{
+    uint64_t total = 0;
+    for (const auto& bucket : buckets) {
+        total += bucket.second;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::max(0.0, std::min(1.0, q)) * (total - 1));
+    uint64_t seen = 0;
+    for (const auto& bucket : buckets) {
+        seen += bucket.second;
+        if (seen > rank) {
+            return bucket.first;
+        }
+    }
+    return buckets.back().first;
+}
+
+const AlgorithmSnapshot* Snapshot::find(HashAlgorithm algorithm) const
+{
+    for (const auto& stats : algorithms) {
+        if (stats.algorithm == algorithm) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+Snapshot snapshot(void)
+{
+    Snapshot result;
+    if (!ENABLED) {
+        return result;
+    }
+
+    // the totals are big, build them on the heap
+    std::unique_ptr<ThreadStats> total(new ThreadStats());
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        merge(*total, r.retired);
+        for (auto stats : r.live) {
+            merge(*total, *stats);
+        }
+    }
+
+    for (size_t a = 0; a < ALGORITHMS; ++a) {
+        const auto& stats = total->algorithms[a];
+        if (stats.updates.load() == 0 && stats.getHashes.load() == 0) {
+            continue;
+        }
+
+        AlgorithmSnapshot entry;
+        entry.algorithm = static_cast<HashAlgorithm>(a);
+        entry.bytes = stats.bytes.load();
+        entry.blocks = stats.blocks.load();
+        entry.partialCopies = stats.partialCopies.load();
+        entry.updates = stats.updates.load();
+        entry.getHashes = stats.getHashes.load();
+        entry.updateLatency = snapshotOf(stats.updateLatency);
+        entry.getHashLatency = snapshotOf(stats.getHashLatency);
+        result.algorithms.push_back(std::move(entry));
+    }
+    return result;
+}
+
+void reset(void)
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.clear();
+    for (auto stats : r.live) {
+        stats->clear();
+    }
+}
+
+} /* namespace instrumentation */
+
+namespace instrumentation_detail {
+
+uint64_t beginUpdate(void)
+{
+    return begin(t_updateCountdown);
+}
+
+uint64_t beginGetHash(void)
+{
+    return begin(t_getHashCountdown);
+}
+
+void onUpdate(HashAlgorithm algorithm, uint64_t bytes, uint64_t blocks, uint64_t partialCopies, uint64_t start)
+{
+    auto& stats = local(algorithm);
+    add(stats.bytes, bytes);
+    add(stats.blocks, blocks);
+    add(stats.partialCopies, partialCopies);
+    add(stats.updates, 1);
+    if (start != 0) {
+        stats.updateLatency.record(now() - start);
+    }
+}
+
+void onGetHash(HashAlgorithm algorithm, uint64_t blocks, uint64_t start)
+{
+    auto& stats = local(algorithm);
+    add(stats.blocks, blocks);
+    add(stats.getHashes, 1);
+    if (start != 0) {
+        stats.getHashLatency.record(now() - start);
+    }
+}
+
+} /* namespace instrumentation_detail */
+} /* namespace crypto */
@@ -1,15 +1,26 @@
 #include "MD5.hpp"
 #include "HashingStrategy.hpp"
-#include "utils.hpp"
+#include "Dispatch.hpp"
+#include "MD5Constants.hpp"
 #include "endian.hpp"
 
 namespace crypto {
 
-using namespace utils;
-
 MD5hashing::MD5hashing(void) :
-    HS(std::make_unique<MD5hashing::MD5BlockCipherLike>())
+    HS(InPlace<MD5hashing::MD5BlockCipherLike>())
+{
+}
+
+MD5hashing MD5hashing::clone(void) const
+{
+    MD5hashing copy;
+    copy.copyStateFrom(*this);
+    return copy;
+}
+
+HashAlgorithm MD5hashing::algorithm(void) const
 {
+    return HashAlgorithm::MD5;
 }
 
 MD5hashing::MD5BlockCipherLike::MD5BlockCipherLike(void)
@@ -22,12 +33,7 @@ void MD5hashing::MD5BlockCipherLike::reset(void)
 {
     m_msgBlock.fill(0);
     m_spaceAvailable = m_msgBlock;
-    m_intermediateHash = {
-        0x67452301,
-        0xEFCDAB89,
-        0x98BADCFE,
-        0x10325476
-    };
+    m_intermediateHash = md5_detail::IV;
 }
 
 MD5hash MD5hashing::MD5BlockCipherLike::getDigest(void)
@@ -60,116 +66,9 @@ void MD5hashing::MD5BlockCipherLike::setMsgSize(size_t size)
     dest.back() = htole64(size);
 }
 
-void MD5hashing::MD5BlockCipherLike::process(void)
+void MD5hashing::MD5BlockCipherLike::processBlocks(const uint8_t* blocks, size_t nblocks)
 {
-    auto F = [](auto x, auto y, auto z) { return (x & y) | ((~x) & z); };
-    auto G = [](auto x, auto y, auto z) { return (x & z) | (y & (~z)); };
-    auto H = [](auto x, auto y, auto z) { return x ^ y ^ z; };
-    auto I = [](auto x, auto y, auto z) { return y ^ (x | (~z)); };
-
-    auto f = [](auto x) { return x % 16; };
-    auto g = [](auto x) { return (5 * x + 1) % 16; };
-    auto h = [](auto x) { return (3 * x + 5) % 16; };
-    auto i = [](auto x) { return (7 * x) % 16; };
-
-    auto XX = [](auto X, auto &a, auto b, auto c, auto d, auto k, auto w, auto s)
-    {
-        a += X(b,c,d) + k + w;
-        a = rotate_left(a,s);
-        a += b;
-    };
-
-    auto& msgBlock = *reinterpret_cast<MsgBlock_uint32*>(m_msgBlock.data());
-
-    //std::array<uint32_t, MD5_MSGBLOCK_SIZE> K;
-    //for (uint8_t i = 0; i < MD5_MSGBLOCK_SIZE; ++i) {
-    //    K[i] = floor((1 << 32) * abs(sin(i + 1)));
-    //}
-
-    static std::array<uint32_t, std::tuple_size<MsgBlock_uint32>::value * 4> const K =
-    {
-        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
-        0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
-        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
-        0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
-        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
-        0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
-        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
-        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
-        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
-        0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
-        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
-        0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
-        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
-        0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
-        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
-        0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
-    };
-
-    static const std::array<uint8_t, std::tuple_size<MsgBlock_uint32>::value> ref_leftshift =
-    {
-        7, 12, 17, 22,
-        5,  9, 14, 20,
-        4, 11, 16, 23,
-        6, 10, 15, 21,
-    };
-
-    auto shift = [](auto x) { return (x / 16) * 4 + (x % 4); };
-
-    MsgBlock_uint32 W;
-    uint32_t A, B, C, D;
-
-    // initialize the first 16 words in the array W
-    std::transform(msgBlock.begin(),
-                   msgBlock.end(),
-                   W.begin(),
-                   [](uint32_t n) { return htole32(n); });
-
-    A = m_intermediateHash[0];
-    B = m_intermediateHash[1];
-    C = m_intermediateHash[2];
-    D = m_intermediateHash[3];
-
-    for (uint8_t t = 0; t < 16; ++t) {
-        XX( F, A, B, C, D, K[t], W[ f(t) ], ref_leftshift[ shift(t) ] );
-        auto temp = D;
-        D = C;
-        C = B;
-        B = A;
-        A = temp;
-    }
-
-    for (uint8_t t = 16; t < 32; ++t) {
-        XX( G, A, B, C, D, K[t], W[ g(t) ], ref_leftshift[ shift(t) ] );
-        auto temp = D;
-        D = C;
-        C = B;
-        B = A;
-        A = temp;
-    }
-
-    for (uint8_t t = 32; t < 48; ++t) {
-        XX( H, A, B, C, D, K[t], W[ h(t) ], ref_leftshift[ shift(t) ] );
-        auto temp = D;
-        D = C;
-        C = B;
-        B = A;
-        A = temp;
-    }
-
-    for (uint8_t t = 48; t < 64; ++t) {
-        XX( I, A, B, C, D, K[t], W[ i(t) ], ref_leftshift[ shift(t) ] );
-        auto temp = D;
-        D = C;
-        C = B;
-        B = A;
-        A = temp;
-    }
-
-    m_intermediateHash[0] += A;
-    m_intermediateHash[1] += B;
-    m_intermediateHash[2] += C;
-    m_intermediateHash[3] += D;
+    dispatch::md5()(m_intermediateHash.data(), blocks, nblocks);
 }
 
 } /* namespace crypto */
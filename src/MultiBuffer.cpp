@@ -0,0 +1,489 @@
+#include "MultiBuffer.hpp"
+#include "MultiBufferKernels.hpp"
+#include "MD5Constants.hpp"
+#include "SHA1Constants.hpp"
+#include "SHA256224Constants.hpp"
+#include "SHA512384Constants.hpp"
+#include "cpuid.hpp"
+#include "Padding.hpp"
+#include "endian.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace crypto {
+namespace multibuffer {
+
+using namespace multibuffer_detail;
+
+namespace {
+
+/* Per-algorithm description of the padding and of the digest layout, mirroring
+ * what the BlockCipherLike classes do with setMsgSize() and getDigest().
+ **/
+struct MD5traits
+{
+    using Word = uint32_t;
+    using Kernel = Kernel32;
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t LENGTH_SIZE = 8;
+    static constexpr size_t DIGEST_SIZE = MD5_HASH_SIZE;
+    static constexpr bool BIG_ENDIAN_WORDS = false;
+    static constexpr size_t STATE_WORDS = 4;
+    static const Word* iv(void) { return md5_detail::IV.data(); }
+};
+
+struct SHA1traits
+{
+    using Word = uint32_t;
+    using Kernel = Kernel32;
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t LENGTH_SIZE = 8;
+    static constexpr size_t DIGEST_SIZE = SHA1_HASH_SIZE;
+    static constexpr bool BIG_ENDIAN_WORDS = true;
+    static constexpr size_t STATE_WORDS = 5;
+    static const Word* iv(void) { return sha1_detail::IV.data(); }
+};
+
+struct SHA256traits
+{
+    using Word = uint32_t;
+    using Kernel = Kernel32;
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t LENGTH_SIZE = 8;
+    static constexpr size_t DIGEST_SIZE = SHA256_HASH_SIZE;
+    static constexpr bool BIG_ENDIAN_WORDS = true;
+    static constexpr size_t STATE_WORDS = 8;
+    static const Word* iv(void) { return sha256224_detail::IV256.data(); }
+};
+
+struct SHA512traits
+{
+    using Word = uint64_t;
+    using Kernel = Kernel64;
+    static constexpr size_t BLOCK_SIZE = 128;
+    static constexpr size_t LENGTH_SIZE = 16;
+    static constexpr size_t DIGEST_SIZE = SHA512_HASH_SIZE;
+    static constexpr bool BIG_ENDIAN_WORDS = true;
+    static constexpr size_t STATE_WORDS = 8;
+    static const Word* iv(void) { return sha512384_detail::IV512.data(); }
+};
+
+inline uint32_t toHost(uint32_t n, bool bigEndian) { return bigEndian ? be32toh(n) : le32toh(n); }
+inline uint64_t toHost(uint64_t n, bool bigEndian) { return bigEndian ? be64toh(n) : le64toh(n); }
+inline uint32_t fromHost(uint32_t n, bool bigEndian) { return bigEndian ? htobe32(n) : htole32(n); }
+inline uint64_t fromHost(uint64_t n, bool bigEndian) { return bigEndian ? htobe64(n) : htole64(n); }
+
+/* Feeds N_lanes messages at a time to a lane-parallel kernel.
+ *
+ * Each lane reads the full blocks of its message in place, then one or two
+ * padded blocks built in the lane's tail buffer. When a lane has consumed its
+ * last block its digest is extracted and the next pending message takes its
+ * place; lanes left without a message compress a zero block whose result is
+ * never read.
+ **/
+template <typename Traits, size_t N_lanes>
+void run(gsl::span<const gsl::span<const uint8_t>> msgs,
+         gsl::span<CryptoHash<Traits::DIGEST_SIZE>> digests,
+         typename Traits::Kernel kernel)
+{
+    using Word = typename Traits::Word;
+    constexpr auto BLOCK_SIZE = Traits::BLOCK_SIZE;
+    constexpr auto STATE_WORDS = Traits::STATE_WORDS;
+    constexpr auto BLOCK_WORDS = BLOCK_SIZE / sizeof(Word);
+
+    struct Lane
+    {
+        std::ptrdiff_t msg;         // index of the message, -1 when the lane is idle
+        const uint8_t* data;        // next full block of the message
+        size_t fullBlocks;          // full blocks left in the message
+        size_t tailBlocks;          // padded blocks left in tail
+        const uint8_t* tailBlock;   // next padded block
+        uint8_t tail[2 * BLOCK_SIZE];
+    };
+
+    alignas(64) Word state[STATE_WORDS * N_lanes];
+    alignas(64) Word words[BLOCK_WORDS * N_lanes];
+    static const uint8_t zeroBlock[BLOCK_SIZE] = {};
+
+    std::array<Lane, N_lanes> lanes;
+    std::ptrdiff_t next = 0;
+    size_t active = 0;
+
+    auto load = [&](size_t l) {
+        auto& lane = lanes[l];
+        if (next == msgs.size()) {
+            lane.msg = -1;
+            return;
+        }
+
+        auto msg = msgs[next];
+        auto size = static_cast<size_t>(msg.size());
+        auto tailSize = size % BLOCK_SIZE;
+
+        lane.msg = next++;
+        lane.data = msg.data();
+        lane.fullBlocks = size / BLOCK_SIZE;
+        lane.tailBlock = lane.tail;
+
+        if (tailSize > 0) {
+            std::memcpy(lane.tail, msg.data() + size - tailSize, tailSize);
+        }
+        const auto last = padding_detail::padTail<BLOCK_SIZE, Traits::LENGTH_SIZE, Traits::BIG_ENDIAN_WORDS>(
+            lane.tail, tailSize, size, padding_detail::followingBlock<BLOCK_SIZE>);
+        lane.tailBlocks = static_cast<size_t>(last - lane.tail) / BLOCK_SIZE + 1;
+
+        for (size_t w = 0; w < STATE_WORDS; ++w) {
+            state[w * N_lanes + l] = Traits::iv()[w];
+        }
+        ++active;
+    };
+
+    for (size_t l = 0; l < N_lanes; ++l) {
+        load(l);
+    }
+
+    while (active > 0) {
+        // transpose the next block of every lane into word-major order
+        for (size_t l = 0; l < N_lanes; ++l) {
+            const auto& lane = lanes[l];
+            const uint8_t* block = zeroBlock;
+            if (lane.msg >= 0) {
+                block = (lane.fullBlocks > 0) ? lane.data : lane.tailBlock;
+            }
+            for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                Word n;
+                std::memcpy(&n, block + w * sizeof(Word), sizeof(Word));
+                words[w * N_lanes + l] = toHost(n, Traits::BIG_ENDIAN_WORDS);
+            }
+        }
+
+        kernel(state, words);
+
+        for (size_t l = 0; l < N_lanes; ++l) {
+            auto& lane = lanes[l];
+            if (lane.msg < 0) {
+                continue;
+            }
+
+            if (lane.fullBlocks > 0) {
+                --lane.fullBlocks;
+                lane.data += BLOCK_SIZE;
+                continue;
+            }
+
+            lane.tailBlock += BLOCK_SIZE;
+            if (--lane.tailBlocks > 0) {
+                continue;
+            }
+
+            auto& digest = digests[lane.msg];
+            for (size_t w = 0; w < Traits::DIGEST_SIZE / sizeof(Word); ++w) {
+                auto n = fromHost(state[w * N_lanes + l], Traits::BIG_ENDIAN_WORDS);
+                std::memcpy(digest.data() + w * sizeof(Word), &n, sizeof(Word));
+            }
+            --active;
+            load(l);
+        }
+    }
+
+    // messages may be sensitive, clear out the copies of their blocks
+    for (auto& lane : lanes) {
+        utils::wipe(lane.tail, sizeof(lane.tail));
+    }
+    utils::wipe(words, sizeof(words));
+}
+
+/* Padded tail of records of a given length, shared by all of them: the template of the
+ * tail blocks and its words in host byte order, the ones past the record bytes being the
+ * same in every lane.
+ **/
+template <typename Traits>
+struct RecordPadding
+{
+    using Word = typename Traits::Word;
+    static constexpr size_t BLOCK_WORDS = Traits::BLOCK_SIZE / sizeof(Word);
+
+    size_t fullBlocks;
+    size_t tailSize;
+    size_t tailBlocks;
+    size_t dataWords;               // words of the first tail block holding record bytes
+    uint8_t tail[2 * Traits::BLOCK_SIZE];
+    Word words[2 * BLOCK_WORDS];
+
+    explicit RecordPadding(size_t length) :
+        fullBlocks(length / Traits::BLOCK_SIZE),
+        tailSize(length % Traits::BLOCK_SIZE),
+        tailBlocks(0),
+        dataWords((tailSize + sizeof(Word) - 1) / sizeof(Word))
+    {
+        // the record bytes are filled in per lane
+        std::memset(tail, 0, tailSize);
+        const auto last = padding_detail::padTail<Traits::BLOCK_SIZE, Traits::LENGTH_SIZE, Traits::BIG_ENDIAN_WORDS>(
+            tail, tailSize, length, padding_detail::followingBlock<Traits::BLOCK_SIZE>);
+        tailBlocks = static_cast<size_t>(last - tail) / Traits::BLOCK_SIZE + 1;
+
+        for (size_t w = 0; w < tailBlocks * BLOCK_WORDS; ++w) {
+            Word n;
+            std::memcpy(&n, tail + w * sizeof(Word), sizeof(Word));
+            words[w] = toHost(n, Traits::BIG_ENDIAN_WORDS);
+        }
+    }
+};
+
+/* Hashes the count records from first on N_lanes at a time. All lanes take the same
+ * number of blocks; in the last group, lanes without a record hash the first record of the
+ * group again and their digest is dropped.
+ **/
+template <typename Traits, size_t N_lanes>
+void runRecords(const uint8_t* base, size_t stride, size_t first, size_t count,
+                const RecordPadding<Traits>& padding,
+                CryptoHash<Traits::DIGEST_SIZE>* digests,
+                typename Traits::Kernel kernel)
+{
+    using Word = typename Traits::Word;
+    constexpr auto BLOCK_SIZE = Traits::BLOCK_SIZE;
+    constexpr auto STATE_WORDS = Traits::STATE_WORDS;
+    constexpr auto BLOCK_WORDS = BLOCK_SIZE / sizeof(Word);
+
+    alignas(64) Word state[STATE_WORDS * N_lanes];
+    alignas(64) Word words[BLOCK_WORDS * N_lanes];
+    alignas(64) Word tailWords[2 * BLOCK_WORDS * N_lanes];
+
+    // the padding words are broadcast once, only the record words change per group
+    for (size_t w = 0; w < padding.tailBlocks * BLOCK_WORDS; ++w) {
+        for (size_t l = 0; l < N_lanes; ++l) {
+            tailWords[w * N_lanes + l] = padding.words[w];
+        }
+    }
+
+    const uint8_t* records[N_lanes];
+    for (size_t group = 0; group < count; group += N_lanes) {
+        const auto used = std::min(N_lanes, count - group);
+        for (size_t l = 0; l < N_lanes; ++l) {
+            records[l] = base + (first + group + (l < used ? l : 0)) * stride;
+        }
+
+        for (size_t w = 0; w < STATE_WORDS; ++w) {
+            for (size_t l = 0; l < N_lanes; ++l) {
+                state[w * N_lanes + l] = Traits::iv()[w];
+            }
+        }
+
+        for (size_t b = 0; b < padding.fullBlocks; ++b) {
+            for (size_t l = 0; l < N_lanes; ++l) {
+                const auto block = records[l] + b * BLOCK_SIZE;
+                for (size_t w = 0; w < BLOCK_WORDS; ++w) {
+                    Word n;
+                    std::memcpy(&n, block + w * sizeof(Word), sizeof(Word));
+                    words[w * N_lanes + l] = toHost(n, Traits::BIG_ENDIAN_WORDS);
+                }
+            }
+            kernel(state, words);
+        }
+
+        const auto tailOffset = padding.fullBlocks * BLOCK_SIZE;
+        for (size_t l = 0; l < N_lanes; ++l) {
+            const auto tail = records[l] + tailOffset;
+            const auto fullWords = padding.tailSize / sizeof(Word);
+            for (size_t w = 0; w < fullWords; ++w) {
+                Word n;
+                std::memcpy(&n, tail + w * sizeof(Word), sizeof(Word));
+                tailWords[w * N_lanes + l] = toHost(n, Traits::BIG_ENDIAN_WORDS);
+            }
+            if (fullWords < padding.dataWords) {
+                // the word where the record ends and the padding begins
+                const auto offset = fullWords * sizeof(Word);
+                Word n;
+                std::memcpy(&n, padding.tail + offset, sizeof(Word));
+                std::memcpy(&n, tail + offset, padding.tailSize - offset);
+                tailWords[fullWords * N_lanes + l] = toHost(n, Traits::BIG_ENDIAN_WORDS);
+            }
+        }
+        for (size_t t = 0; t < padding.tailBlocks; ++t) {
+            kernel(state, tailWords + t * BLOCK_WORDS * N_lanes);
+        }
+
+        for (size_t l = 0; l < used; ++l) {
+            auto& digest = digests[first + group + l];
+            for (size_t w = 0; w < Traits::DIGEST_SIZE / sizeof(Word); ++w) {
+                auto n = fromHost(state[w * N_lanes + l], Traits::BIG_ENDIAN_WORDS);
+                std::memcpy(digest.data() + w * sizeof(Word), &n, sizeof(Word));
+            }
+        }
+    }
+
+    // records may be sensitive, clear out the copies of their blocks
+    utils::wipe(words, sizeof(words));
+    utils::wipe(tailWords, sizeof(tailWords));
+}
+
+/* Kernels of one algorithm for 128, 256 and 512-bit vectors.
+ **/
+template <typename Traits>
+struct Engines
+{
+    typename Traits::Kernel k128;
+    typename Traits::Kernel k256;
+    typename Traits::Kernel k512;
+};
+
+enum class Width { V128, V256, V512 };
+
+Width selectWidth(void)
+{
+    static const Width width = [] {
+        const auto& f = cpuid::features();
+        if (f.avx512f && hasAVX512Kernels()) {
+            return Width::V512;
+        }
+        if (f.avx2 && hasAVX2Kernels()) {
+            return Width::V256;
+        }
+        return Width::V128;
+    }();
+    return width;
+}
+
+template <typename Traits>
+size_t width(void)
+{
+    constexpr auto W = sizeof(typename Traits::Word);
+    switch (selectWidth()) {
+        case Width::V512: return 64 / W;
+        case Width::V256: return 32 / W;
+        default:          return 16 / W;
+    }
+}
+
+template <typename Traits>
+bool dispatch(gsl::span<const gsl::span<const uint8_t>> msgs,
+              gsl::span<CryptoHash<Traits::DIGEST_SIZE>> digests,
+              const Engines<Traits>& engines)
+{
+    constexpr auto W = sizeof(typename Traits::Word);
+
+    if (msgs.size() != digests.size()) {
+        return false;
+    }
+
+    switch (selectWidth()) {
+        case Width::V512:
+            run<Traits, 64 / W>(msgs, digests, engines.k512);
+            break;
+        case Width::V256:
+            run<Traits, 32 / W>(msgs, digests, engines.k256);
+            break;
+        default:
+            run<Traits, 16 / W>(msgs, digests, engines.k128);
+            break;
+    }
+    return true;
+}
+
+// records below which hashRecords() does not bother the pool, and per task above it
+static const size_t RECORDS_PER_TASK = 1024;
+
+template <typename Traits>
+bool dispatchRecords(const uint8_t* base, size_t stride, size_t length, size_t count,
+                     gsl::span<CryptoHash<Traits::DIGEST_SIZE>> digests,
+                     const Engines<Traits>& engines, ThreadPool& pool)
+{
+    constexpr auto W = sizeof(typename Traits::Word);
+
+    if (static_cast<size_t>(digests.size()) != count) {
+        return false;
+    }
+
+    const RecordPadding<Traits> padding(length);
+    auto hash = [&](size_t first, size_t n) {
+        switch (selectWidth()) {
+            case Width::V512:
+                runRecords<Traits, 64 / W>(base, stride, first, n, padding, digests.data(), engines.k512);
+                break;
+            case Width::V256:
+                runRecords<Traits, 32 / W>(base, stride, first, n, padding, digests.data(), engines.k256);
+                break;
+            default:
+                runRecords<Traits, 16 / W>(base, stride, first, n, padding, digests.data(), engines.k128);
+                break;
+        }
+    };
+
+    if (pool.size() <= 1 || count < 2 * RECORDS_PER_TASK) {
+        hash(0, count);
+        return true;
+    }
+
+    // whole groups of lanes per task, a few tasks per worker to even out the load
+    const auto lanes = width<Traits>();
+    auto tasks = std::min(count / RECORDS_PER_TASK, 4 * pool.size());
+    auto perTask = (count + tasks - 1) / tasks;
+    perTask = (perTask + lanes - 1) / lanes * lanes;
+    tasks = (count + perTask - 1) / perTask;
+    pool.parallelFor(tasks, [&](size_t task) {
+        auto first = task * perTask;
+        hash(first, std::min(perTask, count - first));
+    });
+    return true;
+}
+
+} /* namespace */
+
+template <>
+bool hashMany<MD5hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<MD5hash> digests)
+{
+    return dispatch<MD5traits>(msgs, digests, { md5x4, md5x8AVX2, md5x16AVX512 });
+}
+
+template <>
+bool hashMany<SHA1hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA1hash> digests)
+{
+    return dispatch<SHA1traits>(msgs, digests, { sha1x4, sha1x8AVX2, sha1x16AVX512 });
+}
+
+template <>
+bool hashMany<SHA256hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA256hash> digests)
+{
+    return dispatch<SHA256traits>(msgs, digests, { sha256x4, sha256x8AVX2, sha256x16AVX512 });
+}
+
+template <>
+bool hashMany<SHA512hashing>(gsl::span<const gsl::span<const uint8_t>> msgs, gsl::span<SHA512hash> digests)
+{
+    return dispatch<SHA512traits>(msgs, digests, { sha512x2, sha512x4AVX2, sha512x8AVX512 });
+}
+
+template <>
+bool hashRecords<MD5hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<MD5hash> digests, ThreadPool& pool)
+{
+    return dispatchRecords<MD5traits>(base, stride, length, count, digests, { md5x4, md5x8AVX2, md5x16AVX512 }, pool);
+}
+
+template <>
+bool hashRecords<SHA1hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA1hash> digests, ThreadPool& pool)
+{
+    return dispatchRecords<SHA1traits>(base, stride, length, count, digests, { sha1x4, sha1x8AVX2, sha1x16AVX512 }, pool);
+}
+
+template <>
+bool hashRecords<SHA256hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA256hash> digests, ThreadPool& pool)
+{
+    return dispatchRecords<SHA256traits>(base, stride, length, count, digests, { sha256x4, sha256x8AVX2, sha256x16AVX512 }, pool);
+}
+
+template <>
+bool hashRecords<SHA512hashing>(const uint8_t* base, size_t stride, size_t length, size_t count, gsl::span<SHA512hash> digests, ThreadPool& pool)
+{
+    return dispatchRecords<SHA512traits>(base, stride, length, count, digests, { sha512x2, sha512x4AVX2, sha512x8AVX512 }, pool);
+}
+
+template <> size_t lanes<MD5hashing>(void) { return width<MD5traits>(); }
+template <> size_t lanes<SHA1hashing>(void) { return width<SHA1traits>(); }
+template <> size_t lanes<SHA256hashing>(void) { return width<SHA256traits>(); }
+template <> size_t lanes<SHA512hashing>(void) { return width<SHA512traits>(); }
+
+} /* namespace multibuffer */
+} /* namespace crypto */
@@ -0,0 +1,28 @@
+#include "MultiBufferKernels.hpp"
+#include "MultiBufferKernels.ipp"
+
+namespace crypto {
+namespace multibuffer_detail {
+
+void md5x4(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 4>::md5(state, words);
+}
+
+void sha1x4(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 4>::sha1(state, words);
+}
+
+void sha256x4(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 4>::sha256(state, words);
+}
+
+void sha512x2(uint64_t* state, const uint64_t* words)
+{
+    Lanes<uint64_t, 2>::sha512(state, words);
+}
+
+} /* namespace multibuffer_detail */
+} /* namespace crypto */
@@ -0,0 +1,40 @@
+#ifndef _CRYPTO_MULTIBUFFER_KERNELS_HPP
+#define _CRYPTO_MULTIBUFFER_KERNELS_HPP
+
+#include <cstdint>
+
+namespace crypto {
+namespace multibuffer_detail {
+
+/* A kernel compresses one block in each of its lanes at once.
+ * Both arrays are word-major: state[w * LANES + lane] holds word w of the lane's
+ * intermediate hash, words[w * LANES + lane] word w of the lane's block, already
+ * converted to host byte order.
+ **/
+using Kernel32 = void (*)(uint32_t* state, const uint32_t* words);
+using Kernel64 = void (*)(uint64_t* state, const uint64_t* words);
+
+// 128-bit vectors, built for the baseline instruction set (MultiBufferKernels.cpp)
+void md5x4(uint32_t* state, const uint32_t* words);
+void sha1x4(uint32_t* state, const uint32_t* words);
+void sha256x4(uint32_t* state, const uint32_t* words);
+void sha512x2(uint64_t* state, const uint64_t* words);
+
+// 256-bit vectors (MultiBufferKernels_AVX2.cpp), only valid when hasAVX2Kernels() is true
+bool hasAVX2Kernels(void);
+void md5x8AVX2(uint32_t* state, const uint32_t* words);
+void sha1x8AVX2(uint32_t* state, const uint32_t* words);
+void sha256x8AVX2(uint32_t* state, const uint32_t* words);
+void sha512x4AVX2(uint64_t* state, const uint64_t* words);
+
+// 512-bit vectors (MultiBufferKernels_AVX512.cpp), only valid when hasAVX512Kernels() is true
+bool hasAVX512Kernels(void);
+void md5x16AVX512(uint32_t* state, const uint32_t* words);
+void sha1x16AVX512(uint32_t* state, const uint32_t* words);
+void sha256x16AVX512(uint32_t* state, const uint32_t* words);
+void sha512x8AVX512(uint64_t* state, const uint64_t* words);
+
+} /* namespace multibuffer_detail */
+} /* namespace crypto */
+
+#endif /* _CRYPTO_MULTIBUFFER_KERNELS_HPP */
@@ -0,0 +1,214 @@
+/* Lane-parallel compression functions written once over GCC/Clang vector
+ * extensions and instantiated by each MultiBufferKernels*.cpp for the vector
+ * width its instruction set provides.
+ *
+ * Everything here has internal linkage on purpose: the including translation
+ * units are built with different -m flags, and a shared inline definition
+ * could otherwise be resolved to the copy that uses the widest instructions.
+ **/
+
+#include "MD5Constants.hpp"
+#include "SHA1Constants.hpp"
+#include "SHA256224Constants.hpp"
+#include "SHA512384Constants.hpp"
+
+#include <cstring>
+#include <cstddef>
+
+namespace crypto {
+namespace multibuffer_detail {
+namespace {
+
+template <typename T, size_t N_lanes>
+struct Lanes
+{
+    typedef T V __attribute__((vector_size(sizeof(T) * N_lanes)));
+
+    static inline V load(const T* p)
+    {
+        V v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void store(T* p, V v)
+    {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    static inline V rotl(V x, unsigned int n)
+    {
+        return (x << n) | (x >> (sizeof(T) * 8 - n));
+    }
+
+    static inline V rotr(V x, unsigned int n)
+    {
+        return (x >> n) | (x << (sizeof(T) * 8 - n));
+    }
+
+    static inline void md5(T* state, const T* words)
+    {
+        using md5_detail::K;
+        using md5_detail::S;
+
+        V W[16];
+        for (size_t i = 0; i < 16; ++i) {
+            W[i] = load(words + i * N_lanes);
+        }
+
+        V A = load(state + 0 * N_lanes);
+        V B = load(state + 1 * N_lanes);
+        V C = load(state + 2 * N_lanes);
+        V D = load(state + 3 * N_lanes);
+
+        auto step = [&](V f, size_t t, size_t g) {
+            auto temp = D;
+            D = C;
+            C = B;
+            B = B + rotl(A + f + K[t] + W[g], S[(t / 16) * 4 + (t % 4)]);
+            A = temp;
+        };
+
+#pragma GCC unroll 16
+        for (size_t t = 0; t < 16; ++t) {
+            step((B & C) | (~B & D), t, t);
+        }
+#pragma GCC unroll 16
+        for (size_t t = 16; t < 32; ++t) {
+            step((B & D) | (C & ~D), t, (5 * t + 1) % 16);
+        }
+#pragma GCC unroll 16
+        for (size_t t = 32; t < 48; ++t) {
+            step(B ^ C ^ D, t, (3 * t + 5) % 16);
+        }
+#pragma GCC unroll 16
+        for (size_t t = 48; t < 64; ++t) {
+            step(C ^ (B | ~D), t, (7 * t) % 16);
+        }
+
+        store(state + 0 * N_lanes, load(state + 0 * N_lanes) + A);
+        store(state + 1 * N_lanes, load(state + 1 * N_lanes) + B);
+        store(state + 2 * N_lanes, load(state + 2 * N_lanes) + C);
+        store(state + 3 * N_lanes, load(state + 3 * N_lanes) + D);
+    }
+
+    static inline void sha1(T* state, const T* words)
+    {
+        using sha1_detail::K;
+
+        // 16-word rolling window of the message schedule
+        V W[16];
+        for (size_t i = 0; i < 16; ++i) {
+            W[i] = load(words + i * N_lanes);
+        }
+
+        V A = load(state + 0 * N_lanes);
+        V B = load(state + 1 * N_lanes);
+        V C = load(state + 2 * N_lanes);
+        V D = load(state + 3 * N_lanes);
+        V E = load(state + 4 * N_lanes);
+
+        auto step = [&](V f, size_t t) {
+            if (t >= 16) {
+                W[t % 16] = rotl(W[(t - 3) % 16] ^ W[(t - 8) % 16] ^ W[(t - 14) % 16] ^ W[t % 16], 1);
+            }
+            auto temp = rotl(A, 5) + f + E + W[t % 16] + K[t / 20];
+            E = D;
+            D = C;
+            C = rotl(B, 30);
+            B = A;
+            A = temp;
+        };
+
+#pragma GCC unroll 20
+        for (size_t t = 0; t < 20; ++t) {
+            step((B & C) | (~B & D), t);
+        }
+#pragma GCC unroll 20
+        for (size_t t = 20; t < 40; ++t) {
+            step(B ^ C ^ D, t);
+        }
+#pragma GCC unroll 20
+        for (size_t t = 40; t < 60; ++t) {
+            step((B & C) | (D & (B | C)), t);
+        }
+#pragma GCC unroll 20
+        for (size_t t = 60; t < 80; ++t) {
+            step(B ^ C ^ D, t);
+        }
+
+        store(state + 0 * N_lanes, load(state + 0 * N_lanes) + A);
+        store(state + 1 * N_lanes, load(state + 1 * N_lanes) + B);
+        store(state + 2 * N_lanes, load(state + 2 * N_lanes) + C);
+        store(state + 3 * N_lanes, load(state + 3 * N_lanes) + D);
+        store(state + 4 * N_lanes, load(state + 4 * N_lanes) + E);
+    }
+
+    /* SHA-256 and SHA-512 share their structure, only the constants, the rotation
+     * amounts and the number of rounds differ.
+     **/
+    template <size_t N_rounds, typename T_constants,
+              unsigned int EP0a, unsigned int EP0b, unsigned int EP0c,
+              unsigned int EP1a, unsigned int EP1b, unsigned int EP1c,
+              unsigned int SIG0a, unsigned int SIG0b, unsigned int SIG0c,
+              unsigned int SIG1a, unsigned int SIG1b, unsigned int SIG1c>
+    static inline void sha2(T* state, const T* words, const T_constants& K)
+    {
+        V W[16];
+        for (size_t i = 0; i < 16; ++i) {
+            W[i] = load(words + i * N_lanes);
+        }
+
+        V S[8];
+        for (size_t i = 0; i < 8; ++i) {
+            S[i] = load(state + i * N_lanes);
+        }
+
+        V A = S[0], B = S[1], C = S[2], D = S[3], E = S[4], F = S[5], G = S[6], H = S[7];
+
+#pragma GCC unroll 16
+        for (size_t t = 0; t < N_rounds; ++t) {
+            if (t >= 16) {
+                auto w15 = W[(t - 15) % 16];
+                auto w2 = W[(t - 2) % 16];
+                auto sig0 = rotr(w15, SIG0a) ^ rotr(w15, SIG0b) ^ (w15 >> SIG0c);
+                auto sig1 = rotr(w2, SIG1a) ^ rotr(w2, SIG1b) ^ (w2 >> SIG1c);
+                W[t % 16] = sig1 + W[(t - 7) % 16] + sig0 + W[t % 16];
+            }
+
+            auto T1 = H + (rotr(E, EP1a) ^ rotr(E, EP1b) ^ rotr(E, EP1c)) + ((E & F) ^ (~E & G)) + K[t] + W[t % 16];
+            auto T2 = (rotr(A, EP0a) ^ rotr(A, EP0b) ^ rotr(A, EP0c)) + ((A & B) ^ (A & C) ^ (B & C));
+            H = G;
+            G = F;
+            F = E;
+            E = D + T1;
+            D = C;
+            C = B;
+            B = A;
+            A = T1 + T2;
+        }
+
+        store(state + 0 * N_lanes, S[0] + A);
+        store(state + 1 * N_lanes, S[1] + B);
+        store(state + 2 * N_lanes, S[2] + C);
+        store(state + 3 * N_lanes, S[3] + D);
+        store(state + 4 * N_lanes, S[4] + E);
+        store(state + 5 * N_lanes, S[5] + F);
+        store(state + 6 * N_lanes, S[6] + G);
+        store(state + 7 * N_lanes, S[7] + H);
+    }
+
+    static inline void sha256(T* state, const T* words)
+    {
+        sha2<64, decltype(sha256224_detail::K), 2, 13, 22, 6, 11, 25, 7, 18, 3, 17, 19, 10>(state, words, sha256224_detail::K);
+    }
+
+    static inline void sha512(T* state, const T* words)
+    {
+        sha2<80, decltype(sha512384_detail::K), 28, 34, 39, 14, 18, 41, 1, 8, 7, 19, 61, 6>(state, words, sha512384_detail::K);
+    }
+};
+
+} /* namespace */
+} /* namespace multibuffer_detail */
+} /* namespace crypto */
@@ -0,0 +1,71 @@
+#include "MultiBufferKernels.hpp"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#include "MultiBufferKernels.ipp"
+#endif
+
+namespace crypto {
+namespace multibuffer_detail {
+
+#if defined(__AVX2__)
+
+bool hasAVX2Kernels(void)
+{
+    return true;
+}
+
+void md5x8AVX2(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 8>::md5(state, words);
+}
+
+void sha1x8AVX2(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 8>::sha1(state, words);
+}
+
+void sha256x8AVX2(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 8>::sha256(state, words);
+}
+
+void sha512x4AVX2(uint64_t* state, const uint64_t* words)
+{
+    Lanes<uint64_t, 4>::sha512(state, words);
+}
+
+#else
+
+// never selected: hasAVX2Kernels() is false when the kernels are not compiled in
+
+bool hasAVX2Kernels(void)
+{
+    return false;
+}
+
+void md5x8AVX2(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha1x8AVX2(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha256x8AVX2(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha512x4AVX2(uint64_t*, const uint64_t*)
+{
+    assert(false);
+}
+
+#endif /* __AVX2__ */
+
+} /* namespace multibuffer_detail */
+} /* namespace crypto */
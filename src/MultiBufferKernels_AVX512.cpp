@@ -0,0 +1,71 @@
+#include "MultiBufferKernels.hpp"
+
+#include <cassert>
+
+#if defined(__AVX512F__)
+#include "MultiBufferKernels.ipp"
+#endif
+
+namespace crypto {
+namespace multibuffer_detail {
+
+#if defined(__AVX512F__)
+
+bool hasAVX512Kernels(void)
+{
+    return true;
+}
+
+void md5x16AVX512(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 16>::md5(state, words);
+}
+
+void sha1x16AVX512(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 16>::sha1(state, words);
+}
+
+void sha256x16AVX512(uint32_t* state, const uint32_t* words)
+{
+    Lanes<uint32_t, 16>::sha256(state, words);
+}
+
+void sha512x8AVX512(uint64_t* state, const uint64_t* words)
+{
+    Lanes<uint64_t, 8>::sha512(state, words);
+}
+
+#else
+
+// never selected: hasAVX512Kernels() is false when the kernels are not compiled in
+
+bool hasAVX512Kernels(void)
+{
+    return false;
+}
+
+void md5x16AVX512(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha1x16AVX512(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha256x16AVX512(uint32_t*, const uint32_t*)
+{
+    assert(false);
+}
+
+void sha512x8AVX512(uint64_t*, const uint64_t*)
+{
+    assert(false);
+}
+
+#endif /* __AVX512F__ */
+
+} /* namespace multibuffer_detail */
+} /* namespace crypto */
@@ -0,0 +1,153 @@
+#include "MultiDigest.hpp"
+
+#include <algorithm>
+
+namespace crypto {
+
+static const uint64_t MAX_MSG_LENGTH = 1UL << 61;
+
+gsl::span<const uint8_t> MultiDigest::Digests::operator[](HashAlgorithm algorithm) const
+{
+    switch (algorithm) {
+        case HashAlgorithm::MD4:    return md4;
+        case HashAlgorithm::MD5:    return md5;
+        case HashAlgorithm::SHA1:   return sha1;
+        case HashAlgorithm::SHA224: return sha224;
+        case HashAlgorithm::SHA256: return sha256;
+        case HashAlgorithm::SHA384: return sha384;
+        case HashAlgorithm::SHA512: return sha512;
+        default:                    return {};
+    }
+}
+
+MultiDigest::MultiDigest(std::initializer_list<HashAlgorithm> algorithms, ThreadPool* pool) :
+    m_enabled(0),
+    m_msgLength(0),
+    m_pool(pool)
+{
+    for (auto algorithm : algorithms) {
+        enable(algorithm);
+    }
+}
+
+MultiDigest::MultiDigest(const std::vector<HashAlgorithm>& algorithms, ThreadPool* pool) :
+    m_enabled(0),
+    m_msgLength(0),
+    m_pool(pool)
+{
+    for (auto algorithm : algorithms) {
+        enable(algorithm);
+    }
+}
+
+void MultiDigest::enable(HashAlgorithm algorithm)
+{
+    auto bit = 1u << static_cast<unsigned>(algorithm);
+    if (algorithm != HashAlgorithm::UNKNOWN && static_cast<size_t>(algorithm) < ALGORITHMS) {
+        m_enabled |= bit;
+    }
+}
+
+bool MultiDigest::has(HashAlgorithm algorithm) const
+{
+    return static_cast<size_t>(algorithm) < ALGORITHMS && (m_enabled & (1u << static_cast<unsigned>(algorithm)));
+}
+
+std::vector<HashAlgorithm> MultiDigest::algorithms(void) const
+{
+    std::vector<HashAlgorithm> result;
+    for (size_t i = 0; i < ALGORITHMS; ++i) {
+        if (has(static_cast<HashAlgorithm>(i))) {
+            result.push_back(static_cast<HashAlgorithm>(i));
+        }
+    }
+    return result;
+}
+
+void MultiDigest::updateOne(HashAlgorithm algorithm, gsl::span<const uint8_t> piece)
+{
+    switch (algorithm) {
+        case HashAlgorithm::MD4:    m_md4.update(piece); break;
+        case HashAlgorithm::MD5:    m_md5.update(piece); break;
+        case HashAlgorithm::SHA1:   m_sha1.update(piece); break;
+        case HashAlgorithm::SHA224: m_sha224.update(piece); break;
+        case HashAlgorithm::SHA256: m_sha256.update(piece); break;
+        case HashAlgorithm::SHA384: m_sha384.update(piece); break;
+        case HashAlgorithm::SHA512: m_sha512.update(piece); break;
+        default:                    break;
+    }
+}
+
+bool MultiDigest::update(gsl::span<const uint8_t> &buf)
+{
+    if (buf.empty()) {
+        return true;
+    }
+
+    // every hasher checks the same bound, fail before any of them took a part of buf
+    if (m_msgLength + buf.size() > MAX_MSG_LENGTH) {
+        return false;
+    }
+    m_msgLength += buf.size();
+
+    const auto size = static_cast<size_t>(buf.size());
+
+    std::array<HashAlgorithm, ALGORITHMS> enabled;
+    size_t count = 0;
+    for (size_t i = 0; i < ALGORITHMS; ++i) {
+        if (has(static_cast<HashAlgorithm>(i))) {
+            enabled[count++] = static_cast<HashAlgorithm>(i);
+        }
+    }
+
+    if (m_pool && m_pool->size() > 0 && count > 1 && size >= PARALLEL_THRESHOLD) {
+        for (size_t offset = 0; offset < size; offset += WINDOW_SIZE) {
+            auto window = buf.subspan(offset, std::min(WINDOW_SIZE, size - offset));
+            m_pool->parallelFor(count, [&](size_t i) {
+                updateOne(enabled[i], window);
+            });
+        }
+        return true;
+    }
+
+    for (size_t offset = 0; offset < size; offset += SLICE_SIZE) {
+        auto slice = buf.subspan(offset, std::min(SLICE_SIZE, size - offset));
+        for (size_t i = 0; i < count; ++i) {
+            updateOne(enabled[i], slice);
+        }
+    }
+
+    return true;
+}
+
+MultiDigest::Digests MultiDigest::getHashes(void)
+{
+    Digests digests = {};
+
+    if (has(HashAlgorithm::MD4))    digests.md4 = m_md4.getHash();
+    if (has(HashAlgorithm::MD5))    digests.md5 = m_md5.getHash();
+    if (has(HashAlgorithm::SHA1))   digests.sha1 = m_sha1.getHash();
+    if (has(HashAlgorithm::SHA224)) digests.sha224 = m_sha224.getHash();
+    if (has(HashAlgorithm::SHA256)) digests.sha256 = m_sha256.getHash();
+    if (has(HashAlgorithm::SHA384)) digests.sha384 = m_sha384.getHash();
+    if (has(HashAlgorithm::SHA512)) digests.sha512 = m_sha512.getHash();
+
+    m_msgLength = 0;
+
+    return digests;
+}
+
+void MultiDigest::reset(void)
+{
+    m_md4.reset();
+    m_md5.reset();
+    m_sha1.reset();
+    m_sha224.reset();
+    m_sha256.reset();
+    m_sha384.reset();
+    m_sha512.reset();
+
+    m_msgLength = 0;
+}
+
+} /* namespace crypto */
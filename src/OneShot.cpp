@@ -0,0 +1,107 @@
+#include "OneShot.hpp"
+#include "Dispatch.hpp"
+#include "MD4Constants.hpp"
+#include "MD5Constants.hpp"
+#include "SHA1Constants.hpp"
+#include "SHA256224Constants.hpp"
+#include "SHA512384Constants.hpp"
+#include "Padding.hpp"
+#include "endian.hpp"
+#include "utils.hpp"
+
+#include <cstring>
+
+namespace crypto {
+
+namespace {
+
+inline uint32_t toOrder(uint32_t word, bool bigEndian)
+{
+    return bigEndian ? htobe32(word) : htole32(word);
+}
+
+inline uint64_t toOrder(uint64_t word, bool bigEndian)
+{
+    return bigEndian ? htobe64(word) : htole64(word);
+}
+
+/* Hashes msg from the initial state iv. Blocks are 16 words; the message length, in bits,
+ * ends the last block on two words (of which only the low 64 bits are ever set).
+ **/
+template <size_t N_digest, bool B_bigEndian, typename Word, size_t N_stateWords>
+CryptoHash<N_digest> oneShot(dispatch::BlockKernel<Word> compress,
+                             const std::array<Word, N_stateWords>& iv,
+                             gsl::span<const uint8_t> msg)
+{
+    constexpr size_t BLOCK_SIZE = 16 * sizeof(Word);
+    constexpr size_t LENGTH_SIZE = 2 * sizeof(Word);
+
+    auto state = iv;
+    const auto size = static_cast<size_t>(msg.size());
+    const auto nblocks = size / BLOCK_SIZE;
+
+    if (nblocks > 0) {
+        compress(state.data(), msg.data(), nblocks);
+    }
+
+    // the tail, the 0x80 marker and the length take one block, or two when they overflow
+    uint8_t tail[2 * BLOCK_SIZE];
+    const auto rest = size % BLOCK_SIZE;
+    if (rest > 0) {
+        std::memcpy(tail, msg.data() + nblocks * BLOCK_SIZE, rest);
+    }
+    const auto last = padding_detail::padTail<BLOCK_SIZE, LENGTH_SIZE, B_bigEndian>(
+        tail, rest, size, padding_detail::followingBlock<BLOCK_SIZE>);
+    const auto ntail = static_cast<size_t>(last - tail) / BLOCK_SIZE + 1;
+
+    compress(state.data(), tail, ntail);
+
+    // message may be sensitive, clear it out
+    utils::wipe(tail, sizeof(tail));
+
+    CryptoHash<N_digest> digest;
+    for (size_t i = 0; i < N_digest / sizeof(Word); ++i) {
+        const auto word = toOrder(state[i], B_bigEndian);
+        std::memcpy(digest.data() + i * sizeof(Word), &word, sizeof(Word));
+    }
+    return digest;
+}
+
+} /* anonymous namespace */
+
+MD4hash md4(gsl::span<const uint8_t> msg)
+{
+    return oneShot<MD4_HASH_SIZE, false>(dispatch::md4(), md4_detail::IV, msg);
+}
+
+MD5hash md5(gsl::span<const uint8_t> msg)
+{
+    return oneShot<MD5_HASH_SIZE, false>(dispatch::md5(), md5_detail::IV, msg);
+}
+
+SHA1hash sha1(gsl::span<const uint8_t> msg)
+{
+    return oneShot<SHA1_HASH_SIZE, true>(dispatch::sha1(), sha1_detail::IV, msg);
+}
+
+SHA224hash sha224(gsl::span<const uint8_t> msg)
+{
+    return oneShot<SHA224_HASH_SIZE, true>(dispatch::sha256(), sha256224_detail::IV224, msg);
+}
+
+SHA256hash sha256(gsl::span<const uint8_t> msg)
+{
+    return oneShot<SHA256_HASH_SIZE, true>(dispatch::sha256(), sha256224_detail::IV256, msg);
+}
+
+SHA384hash sha384(gsl::span<const uint8_t> msg)
+{
+    return oneShot<SHA384_HASH_SIZE, true>(dispatch::sha512(), sha512384_detail::IV384, msg);
+}
+
+SHA512hash sha512(gsl::span<const uint8_t> msg)
+{
+    return oneShot<SHA512_HASH_SIZE, true>(dispatch::sha512(), sha512384_detail::IV512, msg);
+}
+
+} /* namespace crypto */
@@ -1,15 +1,26 @@
 #include "SHA1.hpp"
 #include "HashingStrategy.hpp"
-#include "utils.hpp"
+#include "Dispatch.hpp"
+#include "SHA1Constants.hpp"
 #include "endian.hpp"
 
 namespace crypto {
 
-using namespace utils;
-
 SHA1hashing::SHA1hashing(void) :
-    HS(std::make_unique<SHA1hashing::SHA1BlockCipherLike>())
+    HS(InPlace<SHA1hashing::SHA1BlockCipherLike>())
+{
+}
+
+SHA1hashing SHA1hashing::clone(void) const
 {
+    SHA1hashing copy;
+    copy.copyStateFrom(*this);
+    return copy;
+}
+
+HashAlgorithm SHA1hashing::algorithm(void) const
+{
+    return HashAlgorithm::SHA1;
 }
 
 SHA1hashing::SHA1BlockCipherLike::SHA1BlockCipherLike(void)
@@ -22,13 +33,7 @@ void SHA1hashing::SHA1BlockCipherLike::reset(void)
 {
     m_msgBlock.fill(0);
     m_spaceAvailable = m_msgBlock;
-    m_intermediateHash = {
-        0x67452301,
-        0xEFCDAB89,
-        0x98BADCFE,
-        0x10325476,
-        0xC3D2E1F0
-    };
+    m_intermediateHash = sha1_detail::IV;
 }
 
 SHA1hash SHA1hashing::SHA1BlockCipherLike::getDigest(void)
@@ -61,58 +66,9 @@ void SHA1hashing::SHA1BlockCipherLike::setMsgSize(size_t size)
     dest.back() = htobe64(size);
 }
 
-void SHA1hashing::SHA1BlockCipherLike::process(void)
+void SHA1hashing::SHA1BlockCipherLike::processBlocks(const uint8_t* blocks, size_t nblocks)
 {
-    auto f1 = [](auto a, auto b, auto c) { return (a & b) | ((~a) & c); };
-    auto f2 = [](auto a, auto b, auto c) { return a ^ b ^ c; };
-    auto f3 = [](auto a, auto b, auto c) { return (a & b) | (c & (a | b)); };
-    auto f4 = f2;
-    std::function<uint32_t(uint32_t,uint32_t,uint32_t)> F[4] = {f1,f2,f3,f4};
-
-    std::array<const uint32_t, 4> K = {
-        0x5A827999,
-        0x6ED9EBA1,
-        0x8F1BBCDC,
-        0xCA62C1D6
-    }; // Constants defined in SHA-1
-
-    auto& msgBlock = *reinterpret_cast<MsgBlock_uint32*>(m_msgBlock.data());
-    std::array<uint32_t, 80> W; // word sequence
-    uint32_t A, B, C, D, E;     // word buffers
-
-    // initialize the first 16 words in the array W with the message block
-    std::transform(msgBlock.cbegin(),
-                   msgBlock.cend(),
-                   W.begin(),
-                   [] (uint32_t n) { return htobe32(n); });
-
-    for (auto t = msgBlock.size(); t < W.size(); ++t) {
-        W[t] = rotate_left(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16], 1);
-    }
-
-    A = m_intermediateHash[0];
-    B = m_intermediateHash[1];
-    C = m_intermediateHash[2];
-    D = m_intermediateHash[3];
-    E = m_intermediateHash[4];
-
-    for (auto i = 0; i < 4; ++i) {
-        for (auto t = i*W.size()/4; t < (i+1)*W.size()/4; ++t) {
-            auto temp = rotate_left(A,5) + F[i](B,C,D) + E + W[t] + K[i];
-            E = D;
-            D = C;
-            C = rotate_left(B,30);
-            B = A;
-            A = temp;
-        }
-    }
-
-    m_intermediateHash[0] += A;
-    m_intermediateHash[1] += B;
-    m_intermediateHash[2] += C;
-    m_intermediateHash[3] += D;
-    m_intermediateHash[4] += E;
+    dispatch::sha1()(m_intermediateHash.data(), blocks, nblocks);
 }
 
 } /* namespace crypto */
-
@@ -0,0 +1,80 @@
+#include "SHA1.hpp"
+#include "SHA1Constants.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace sha1_detail {
+
+#if defined(__AVX2__)
+
+static inline __m256i rol(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+bool hasAVX2(void)
+{
+    const auto& f = cpuid::features();
+    return f.avx2 && f.ssse3;
+}
+
+/* Same expansion as expandSSSE3(), for two blocks at once: the low 128 bits lane of every
+ * vector belongs to the first block, the high one to the second; the byte shifts and
+ * shuffles of AVX2 work within each lane.
+ **/
+void expandAVX2(const uint8_t* twoBlocks, uint32_t* wk0, uint32_t* wk1)
+{
+    const __m256i MASK = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                         12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    __m256i w[20];
+
+    for (int i = 0; i < 4; ++i) {
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(twoBlocks + 16 * i));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(twoBlocks + 64 + 16 * i));
+        w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), MASK);
+    }
+
+    for (int i = 4; i < 8; ++i) {
+        auto x = _mm256_xor_si256(_mm256_xor_si256(w[i - 4], _mm256_alignr_epi8(w[i - 3], w[i - 4], 8)),
+                                  _mm256_xor_si256(w[i - 2], _mm256_srli_si256(w[i - 1], 4)));
+        x = rol(x, 1);
+        w[i] = _mm256_xor_si256(x, rol(_mm256_slli_si256(x, 12), 1));
+    }
+
+    for (int i = 8; i < 20; ++i) {
+        auto x = _mm256_xor_si256(_mm256_xor_si256(_mm256_alignr_epi8(w[i - 1], w[i - 2], 8), w[i - 4]),
+                                  _mm256_xor_si256(w[i - 7], w[i - 8]));
+        w[i] = rol(x, 2);
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        auto v = _mm256_add_epi32(w[i], _mm256_set1_epi32(static_cast<int>(K[i / 5])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(wk0 + 4 * i), _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(wk1 + 4 * i), _mm256_extracti128_si256(v, 1));
+    }
+}
+
+#else
+
+bool hasAVX2(void)
+{
+    return false;
+}
+
+void expandAVX2(const uint8_t*, uint32_t*, uint32_t*)
+{
+    // never selected: hasAVX2() is false when the kernel is not compiled in
+    assert(false);
+}
+
+#endif
+
+} /* namespace sha1_detail */
+} /* namespace crypto */
@@ -0,0 +1,39 @@
+#include "SHA1.hpp"
+#include "SHA1Kernel.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+namespace crypto {
+namespace sha1_detail {
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+
+bool hasSHANI(void)
+{
+    const auto& f = cpuid::features();
+    return f.sha && f.sse41 && f.ssse3;
+}
+
+void processBlocksSHANI(uint32_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    compressSHANI(state, blocks, nblocks);
+}
+
+#else
+
+bool hasSHANI(void)
+{
+    return false;
+}
+
+void processBlocksSHANI(uint32_t*, const uint8_t*, size_t)
+{
+    // never selected: hasSHANI() is false when the kernel is not compiled in
+    assert(false);
+}
+
+#endif
+
+} /* namespace sha1_detail */
+} /* namespace crypto */
@@ -0,0 +1,76 @@
+#include "SHA1.hpp"
+#include "SHA1Constants.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace sha1_detail {
+
+#if defined(__SSSE3__)
+
+static inline __m128i rol(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+bool hasSSSE3(void)
+{
+    return cpuid::features().ssse3;
+}
+
+void expandSSSE3(const uint8_t* block, uint32_t* wk)
+{
+    const __m128i MASK = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    // w[i] holds W[4i..4i+3]
+    __m128i w[20];
+
+    for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i)), MASK);
+    }
+
+    // W[t] = rol1(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]): the W[t-3] of the last lane is the
+    // W[t] of the first one, computed in the same vector, and is folded in afterwards
+    for (int i = 4; i < 8; ++i) {
+        auto x = _mm_xor_si128(_mm_xor_si128(w[i - 4], _mm_alignr_epi8(w[i - 3], w[i - 4], 8)),
+                               _mm_xor_si128(w[i - 2], _mm_srli_si128(w[i - 1], 4)));
+        x = rol(x, 1);
+        w[i] = _mm_xor_si128(x, rol(_mm_slli_si128(x, 12), 1));
+    }
+
+    // from t = 32 on, the equivalent W[t] = rol2(W[t-6] ^ W[t-16] ^ W[t-28] ^ W[t-32]) has
+    // no dependency within a vector
+    for (int i = 8; i < 20; ++i) {
+        auto x = _mm_xor_si128(_mm_xor_si128(_mm_alignr_epi8(w[i - 1], w[i - 2], 8), w[i - 4]),
+                               _mm_xor_si128(w[i - 7], w[i - 8]));
+        w[i] = rol(x, 2);
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        auto k = _mm_set1_epi32(static_cast<int>(K[i / 5]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(wk + 4 * i), _mm_add_epi32(w[i], k));
+    }
+}
+
+#else
+
+bool hasSSSE3(void)
+{
+    return false;
+}
+
+void expandSSSE3(const uint8_t*, uint32_t*)
+{
+    // never selected: hasSSSE3() is false when the kernel is not compiled in
+    assert(false);
+}
+
+#endif
+
+} /* namespace sha1_detail */
+} /* namespace crypto */
@@ -6,10 +6,22 @@ namespace crypto {
     using HS256224 = SHA256224hashing<SHA224_HASH_SIZE>;
 
     SHA224hashing::SHA224hashing(void) :
-        HS256224(std::make_unique<SHA224hashing::SHA224BlockCipherLike>())
+        HS256224(InPlace<SHA224hashing::SHA224BlockCipherLike>())
     {
     }
 
+    SHA224hashing SHA224hashing::clone(void) const
+    {
+        SHA224hashing copy;
+        copy.copyStateFrom(*this);
+        return copy;
+    }
+
+    HashAlgorithm SHA224hashing::algorithm(void) const
+    {
+        return HashAlgorithm::SHA224;
+    }
+
     SHA224hashing::SHA224BlockCipherLike::SHA224BlockCipherLike(void)
         : HS256224::SHA256224BlockCipherLike::SHA256224BlockCipherLike()
     {
@@ -20,16 +32,7 @@ namespace crypto {
     {
         m_msgBlock.fill(0);
         m_spaceAvailable = m_msgBlock;
-        m_intermediateHash = {
-            0xc1059ed8,
-            0x367cd507,
-            0x3070dd17,
-            0xf70e5939,
-            0xffc00b31,
-            0x68581511,
-            0x64f98fa7,
-            0xbefa4fa4
-        };
+        m_intermediateHash = sha256224_detail::IV224;
     }
 
 } /* namespace crypto */
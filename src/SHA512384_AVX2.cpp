@@ -0,0 +1,158 @@
+#include "SHA512.hpp"
+#include "SHA512384Constants.hpp"
+#include "cpuid.hpp"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace crypto {
+namespace sha512384_detail {
+
+#if defined(__AVX2__)
+
+// Everything below is private to this file: it is built with AVX2 enabled and must not
+// provide an out-of-line copy of a function that generic code could end up calling.
+namespace {
+
+    inline uint64_t rotr(uint64_t x, unsigned int n)
+    {
+        return (x >> n) | (x << (64 - n));
+    }
+
+    inline void round(uint64_t a, uint64_t b, uint64_t c, uint64_t& d,
+                      uint64_t e, uint64_t f, uint64_t g, uint64_t& h, uint64_t wk)
+    {
+        h += (rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41)) + (g ^ (e & (f ^ g))) + wk;
+        d += h;
+        h += (rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39)) + ((a & b) | (c & (a | b)));
+    }
+
+    inline __m256i rotr(__m256i x, int n)
+    {
+        return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+    }
+
+    inline __m256i sig0(__m256i x)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(rotr(x, 1), rotr(x, 8)), _mm256_srli_epi64(x, 7));
+    }
+
+    inline __m256i sig1(__m256i x)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(rotr(x, 19), rotr(x, 61)), _mm256_srli_epi64(x, 6));
+    }
+
+    // words 1 to 4 of the 8 words lo || hi
+    inline __m256i shift1(__m256i lo, __m256i hi)
+    {
+        return _mm256_alignr_epi8(_mm256_permute2x128_si256(lo, hi, 0x21), lo, 8);
+    }
+
+    /* W[t..t+3] from w[0..3] = W[t-16..t-1], four words at a time. The sigma1 term of the
+     * last two words depends on the first two of the same vector, so it is added in a
+     * second step; sigma1(0) being 0, the lanes not yet known can simply be zeroed.
+     **/
+    inline __m256i schedule(__m256i w0, __m256i w1, __m256i w2, __m256i w3)
+    {
+        auto x = _mm256_add_epi64(_mm256_add_epi64(w0, sig0(shift1(w0, w1))), shift1(w2, w3));
+        x = _mm256_add_epi64(x, sig1(_mm256_permute2x128_si256(w3, w3, 0x81)));
+        return _mm256_add_epi64(x, sig1(_mm256_permute2x128_si256(x, x, 0x08)));
+    }
+
+    // 4 rounds on wk[0..3]; S is the rotation of the variable names, 0 or 4
+    template <unsigned int S>
+    inline void rounds4(uint64_t* v, const uint64_t* wk)
+    {
+        auto& a = v[(8 - S) % 8];
+        auto& b = v[(9 - S) % 8];
+        auto& c = v[(10 - S) % 8];
+        auto& d = v[(11 - S) % 8];
+        auto& e = v[(12 - S) % 8];
+        auto& f = v[(13 - S) % 8];
+        auto& g = v[(14 - S) % 8];
+        auto& h = v[(15 - S) % 8];
+
+        round(a, b, c, d, e, f, g, h, wk[0]);
+        round(h, a, b, c, d, e, f, g, wk[1]);
+        round(g, h, a, b, c, d, e, f, wk[2]);
+        round(f, g, h, a, b, c, d, e, wk[3]);
+    }
+
+} /* anonymous namespace */
+
+bool hasAVX2(void)
+{
+    return cpuid::features().avx2;
+}
+
+/* The schedule is computed four words at a time, four rounds ahead of the scalar rounds
+ * that consume it, so the vector and the integer units work on the block concurrently.
+ **/
+void processBlocksAVX2(uint64_t* state, const uint8_t* blocks, size_t nblocks)
+{
+    const __m256i MASK = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                         8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (; nblocks > 0; --nblocks, blocks += 128) {
+        alignas(32) uint64_t wk[80];
+        __m256i w[4];
+
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks + 32 * i)), MASK);
+            auto k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(K.data() + 4 * i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(wk + 4 * i), _mm256_add_epi64(w[i], k));
+        }
+
+        uint64_t v[8];
+        for (int i = 0; i < 8; ++i) {
+            v[i] = state[i];
+        }
+
+        // two groups per iteration, so that the names are back in place at the end of it
+        for (unsigned int t = 16; t < 80; t += 8) {
+            for (unsigned int j = 0; j < 8; j += 4) {
+                auto x = schedule(w[0], w[1], w[2], w[3]);
+                w[0] = w[1];
+                w[1] = w[2];
+                w[2] = w[3];
+                w[3] = x;
+
+                auto k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(K.data() + t + j));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(wk + t + j), _mm256_add_epi64(x, k));
+            }
+
+            rounds4<0>(v, wk + t - 16);
+            rounds4<4>(v, wk + t - 12);
+        }
+
+        for (unsigned int t = 64; t < 80; t += 8) {
+            rounds4<0>(v, wk + t);
+            rounds4<4>(v, wk + t + 4);
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            state[i] += v[i];
+        }
+    }
+}
+
+#else
+
+bool hasAVX2(void)
+{
+    return false;
+}
+
+void processBlocksAVX2(uint64_t*, const uint8_t*, size_t)
+{
+    // never selected: hasAVX2() is false when the kernel is not compiled in
+    assert(false);
+}
+
+#endif
+
+} /* namespace sha512384_detail */
+} /* namespace crypto */
@@ -0,0 +1,119 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace crypto {
+
+ThreadPool::ThreadPool(size_t threads) :
+    m_stopping(false)
+{
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size(void) const
+{
+    return m_workers.size();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_wakeup.notify_one();
+}
+
+void ThreadPool::work(void)
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn)
+{
+    if (n == 0) {
+        return;
+    }
+
+    // Helpers may start after the caller already ran every index itself, so the
+    // shared state outlives this call and completion counts indices, not helpers.
+    struct Batch
+    {
+        std::atomic<size_t> next;
+        size_t done;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::function<void(size_t)> fn;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->next = 0;
+    batch->done = 0;
+    batch->fn = fn;
+
+    auto run = [batch, n] {
+        size_t ran = 0;
+        for (auto i = batch->next++; i < n; i = batch->next++) {
+            batch->fn(i);
+            ++ran;
+        }
+        if (ran > 0) {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            batch->done += ran;
+            if (batch->done == n) {
+                batch->finished.notify_all();
+            }
+        }
+    };
+
+    auto helpers = std::min(n - 1, m_workers.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&] { return batch->done == n; });
+}
+
+ThreadPool& ThreadPool::shared(void)
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+} /* namespace crypto */
@@ -0,0 +1,60 @@
+#include "cpuid.hpp"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace crypto {
+namespace cpuid {
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Extended control register XCR0: which register states the OS saves on context switch.
+ **/
+static uint64_t xgetbv0(void)
+{
+    uint32_t eax, edx;
+    __asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+static Features detect(void)
+{
+    Features f = {};
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    bool ymmEnabled = false, zmmEnabled = false;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        f.ssse3 = (ecx & bit_SSSE3) != 0;
+        f.sse41 = (ecx & bit_SSE4_1) != 0;
+
+        if ((ecx & bit_OSXSAVE) != 0) {
+            auto xcr0 = xgetbv0();
+            ymmEnabled = (xcr0 & 0x06) == 0x06;     // XMM and YMM state
+            zmmEnabled = (xcr0 & 0xE6) == 0xE6;     // XMM, YMM, opmask and ZMM state
+        }
+    }
+
+    if (__get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        f.avx2 = ymmEnabled && (ebx & bit_AVX2) != 0;
+        f.avx512f = zmmEnabled && (ebx & bit_AVX512F) != 0;
+        f.sha = (ebx & bit_SHA) != 0;
+    }
+#endif
+
+    return f;
+}
+
+const Features& features(void)
+{
+    static const Features f = detect();
+    return f;
+}
+
+} /* namespace cpuid */
+} /* namespace crypto */
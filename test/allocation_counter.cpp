@@ -0,0 +1,78 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/* Replacements of the global allocation functions counting every allocation of the process,
+ * for the tests of the allocation-free paths. They live apart from the tests, and are never
+ * inlined, so that the compiler does not see new and delete pair up with malloc() and free():
+ * every form which allocates goes through count(), every form which frees through free().
+ **/
+
+std::atomic<size_t> g_allocations {0};
+
+namespace {
+
+    __attribute__((noinline)) void* count(size_t size) noexcept
+    {
+        ++g_allocations;
+        return std::malloc(size != 0 ? size : 1);
+    }
+
+} /* namespace */
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    if (void* p = count(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size)
+{
+    if (void* p = count(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return count(size);
+}
+
+__attribute__((noinline)) void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return count(size);
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
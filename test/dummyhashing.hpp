@@ -4,6 +4,8 @@
 #include "HashingStrategy.hpp"
 #include "endian.hpp"
 
+#include <cstring>
+
 namespace crypto {
 
 #define DUMMY_HASH_SIZE      16 // (in bytes)
@@ -31,31 +33,29 @@ namespace crypto {
             class DUMMYBlockCipherLike final : public StrategyBlockCipherLike
             {
                 private:
-                    virtual void process(void) final override
+                    virtual void processBlocks(const uint8_t* blocks, size_t nblocks) final override
                     {
-                        auto& msgBlock = *reinterpret_cast<MsgBlock_uint32*>(m_msgBlock.data());
-
-                        // initialize the first 16 words in the array W
-                        std::for_each(msgBlock.begin(),
-                                      msgBlock.end(),
-                                      [](uint32_t n) { return htole32(n); });
-
-                        uint32_t A = m_intermediateHash[0];
-                        uint32_t B = m_intermediateHash[1];
-                        uint32_t C = m_intermediateHash[2];
-                        uint32_t D = m_intermediateHash[3];
-
-                        for (uint16_t i=0; i < msgBlock.size(); i+=4) {
-                            A += msgBlock[i];
-                            B += msgBlock[i+1];
-                            C += msgBlock[i+2];
-                            D += msgBlock[i+3];
+                        for (; nblocks > 0; --nblocks, blocks += sizeof(MsgBlock_uint32)) {
+                            MsgBlock_uint32 msgBlock;
+                            std::memcpy(msgBlock.data(), blocks, sizeof(msgBlock));
+
+                            uint32_t A = m_intermediateHash[0];
+                            uint32_t B = m_intermediateHash[1];
+                            uint32_t C = m_intermediateHash[2];
+                            uint32_t D = m_intermediateHash[3];
+
+                            for (uint16_t i=0; i < msgBlock.size(); i+=4) {
+                                A += msgBlock[i];
+                                B += msgBlock[i+1];
+                                C += msgBlock[i+2];
+                                D += msgBlock[i+3];
+                            }
+
+                            m_intermediateHash[0] += A;
+                            m_intermediateHash[1] += B;
+                            m_intermediateHash[2] += C;
+                            m_intermediateHash[3] += D;
                         }
-
-                        m_intermediateHash[0] += A;
-                        m_intermediateHash[1] += B;
-                        m_intermediateHash[2] += C;
-                        m_intermediateHash[3] += D;
                     }
 
                     virtual DUMMYhash getDigest(void) final override
@@ -10,20 +10,54 @@
 #include "SHA256.hpp"
 #include "SHA384.hpp"
 #include "SHA512.hpp"
+#include "MultiBuffer.hpp"
+#include "TreeHashing.hpp"
+#include "ThreadPool.hpp"
+#include "HashFile.hpp"
+#include "AsyncHashFile.hpp"
+#include "StaticHasher.hpp"
+#include "HMAC.hpp"
+#include "Dispatch.hpp"
+#include "HasherPool.hpp"
+#include "OneShot.hpp"
+#include "MultiDigest.hpp"
+#include "Hex.hpp"
+#include "Instrumentation.hpp"
+#include "ConstexprHash.hpp"
+#include "Chunker.hpp"
+#include "DigestCache.hpp"
+#include "HashingStreambuf.hpp"
+#include "SHA1Kernel.hpp"
+#include "SHA512384Kernel.hpp"
 
 #include <string>
 #include <sstream>
 #include <algorithm>
 #include <utility>
 #include <type_traits>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <chrono>
 
 #include <gsl/span>
 
 #include <sys/time.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cstdlib>
 
 using std::cout;
 using std::endl;
 
+// every allocation of the process, counted by allocation_counter.cpp
+extern std::atomic<size_t> g_allocations;
+
 //#define SHOW_TIMING
 
 class TestEnvironment : public ::testing::Environment {
@@ -103,6 +137,1368 @@ void hashProve(HashChallenges<N_challenges>& challenges, HS<N_tmpdigest, N_diges
     }
 }
 
+template <typename Hasher>
+void chunkedHashProve(const std::string& msg)
+{
+    gsl::span<const uint8_t> whole {reinterpret_cast<const uint8_t*>(msg.data()), static_cast<std::ptrdiff_t>(msg.length())};
+
+    Hasher reference;
+    EXPECT_TRUE(reference.update(whole));
+    auto expected = reference.getHash();
+
+    // split the message so that the buffered path, the direct multi-block path
+    // and unaligned blocks read from the caller's buffer are all exercised
+    for (std::ptrdiff_t chunkSize : { 1, 3, 63, 64, 65, 127, 128, 129, 1000 }) {
+        Hasher strategy;
+        auto in = whole;
+        while (!in.empty()) {
+            auto chunk = in.first(std::min(chunkSize, in.size()));
+            EXPECT_TRUE(strategy.update(chunk));
+            in = in.subspan(chunk.size());
+        }
+        EXPECT_EQ(expected, strategy.getHash());
+    }
+}
+
+template <typename Hasher>
+void multiBufferHashProve(const std::string& text)
+{
+    // lengths around the one/two padding blocks boundaries and a few long
+    // messages so that lanes finish at different times and get refilled
+    std::vector<gsl::span<const uint8_t>> msgs;
+    const uint8_t *p = reinterpret_cast<const uint8_t*>(text.data());
+    for (std::ptrdiff_t len = 0; len < 300; len += 7) {
+        msgs.emplace_back(p, len);
+    }
+    msgs.emplace_back(p, static_cast<std::ptrdiff_t>(text.length()));
+    msgs.emplace_back(p + 1, 1000);
+    msgs.emplace_back(p, 111);
+    msgs.emplace_back(p, 112);
+    msgs.emplace_back(p, 239);
+    msgs.emplace_back(p, 240);
+
+    std::vector<crypto::multibuffer::Digest<Hasher>> digests(msgs.size());
+    EXPECT_TRUE(crypto::multibuffer::hashMany<Hasher>(msgs, digests));
+
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        Hasher strategy;
+        if (!msgs[i].empty()) {
+            EXPECT_TRUE(strategy.update(msgs[i]));
+        }
+        EXPECT_EQ(strategy.getHash(), digests[i]) << "message " << i << " of length " << msgs[i].size();
+    }
+
+    EXPECT_FALSE(crypto::multibuffer::hashMany<Hasher>(msgs, gsl::span<crypto::multibuffer::Digest<Hasher>>(digests).first(1)));
+}
+
+template <typename Hasher>
+void hashRecordsProve(void)
+{
+    using Digest = crypto::multibuffer::Digest<Hasher>;
+
+    std::vector<uint8_t> table(300 * 5000);
+    for (size_t i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<uint8_t>(i * 31 + i / 251);
+    }
+
+    auto check = [&](size_t stride, size_t length, size_t count, crypto::ThreadPool& pool) {
+        std::vector<Digest> digests(count);
+        EXPECT_TRUE(crypto::multibuffer::hashRecords<Hasher>(table.data(), stride, length, count, digests, pool));
+        bool same = true;
+        for (size_t i = 0; i < count; ++i) {
+            Hasher strategy;
+            gsl::span<const uint8_t> record {table.data() + i * stride, static_cast<std::ptrdiff_t>(length)};
+            EXPECT_TRUE(strategy.update(record));
+            same = same && strategy.getHash() == digests[i];
+        }
+        EXPECT_TRUE(same) << "stride " << stride << " length " << length << " count " << count;
+    };
+
+    // lengths around the one/two padding blocks boundaries, a partial last group of lanes
+    crypto::ThreadPool single(1);
+    const auto count = 3 * crypto::multibuffer::lanes<Hasher>() + 5;
+    for (size_t length : { 0, 1, 7, 32, 55, 56, 63, 64, 100, 111, 112, 127, 128, 200, 255 }) {
+        check(length + 3, length, count, single);
+    }
+    check(64, 32, 0, single);
+    // records overlapping each other
+    check(5, 32, count, single);
+
+    // runs of records spread over the workers
+    crypto::ThreadPool pool(3);
+    check(40, 32, 5000, pool);
+    check(300, 255, 4099, pool);
+
+    std::vector<Digest> digests(2);
+    EXPECT_FALSE(crypto::multibuffer::hashRecords<Hasher>(table.data(), 32, 32, 3, digests));
+}
+
+template <typename Hasher>
+crypto::multibuffer::Digest<Hasher> treeHashReference(gsl::span<const uint8_t> msg, std::ptrdiff_t leafSize)
+{
+    // straight recursive transcription of the definition in TreeHashing.hpp
+    Hasher hasher;
+    if (msg.size() <= leafSize) {
+        gsl::span<const uint8_t> prefix {reinterpret_cast<const uint8_t*>("\x00"), 1};
+        hasher.update(prefix);
+        if (!msg.empty()) {
+            hasher.update(msg);
+        }
+        return hasher.getHash();
+    }
+
+    std::ptrdiff_t k = leafSize;
+    while (2 * k < msg.size()) {
+        k *= 2;
+    }
+    auto left = treeHashReference<Hasher>(msg.first(k), leafSize);
+    auto right = treeHashReference<Hasher>(msg.subspan(k), leafSize);
+
+    gsl::span<const uint8_t> in {reinterpret_cast<const uint8_t*>("\x01"), 1};
+    hasher.update(in);
+    in = left;
+    hasher.update(in);
+    in = right;
+    hasher.update(in);
+    return hasher.getHash();
+}
+
+template <typename Hasher>
+void treeHashProve(const std::string& text)
+{
+    constexpr std::ptrdiff_t LEAF_SIZE = 64;
+    gsl::span<const uint8_t> whole {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+
+    // more workers than leaves buffered, too
+    for (size_t threads : { 1, 3, 6 }) {
+        crypto::ThreadPool pool(threads);
+        crypto::TreeHashing<Hasher> tree(LEAF_SIZE, pool);
+
+        for (std::ptrdiff_t len : { std::ptrdiff_t(0), std::ptrdiff_t(1), LEAF_SIZE, LEAF_SIZE + 1, 3 * LEAF_SIZE, 5 * LEAF_SIZE - 1, whole.size() }) {
+            auto msg = whole.first(len);
+            auto expected = treeHashReference<Hasher>(msg, LEAF_SIZE);
+
+            if (!msg.empty()) {
+                EXPECT_TRUE(tree.update(msg));
+            }
+            EXPECT_EQ(expected, tree.getHash()) << len << " bytes, " << threads << " threads";
+
+            // buffered leaves and leaves read from the caller's buffer must agree
+            for (std::ptrdiff_t chunkSize : { 1, 37, 64, 200 }) {
+                auto in = msg;
+                while (!in.empty()) {
+                    auto chunk = in.first(std::min(chunkSize, in.size()));
+                    EXPECT_TRUE(tree.update(chunk));
+                    in = in.subspan(chunk.size());
+                }
+                EXPECT_EQ(expected, tree.getHash()) << len << " bytes in chunks of " << chunkSize;
+            }
+        }
+    }
+
+    // a single leaf is not the plain digest of the message
+    Hasher plain;
+    EXPECT_TRUE(plain.update(whole));
+    crypto::TreeHashing<Hasher> tree;
+    EXPECT_TRUE(tree.update(whole));
+    EXPECT_NE(plain.getHash(), tree.getHash());
+}
+
+template <typename Hasher>
+void hashFileProve(const std::string& text)
+{
+    using Digest = decltype(std::declval<Hasher&>().getHash());
+
+    gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+    Hasher reference;
+    EXPECT_TRUE(reference.update(msg));
+    auto expected = reference.getHash();
+    auto empty = reference.getHash();
+
+    // regular file, mapped
+    char path[] = "/tmp/test-crypto-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(static_cast<ssize_t>(text.length()), write(fd, text.data(), text.length()));
+    close(fd);
+
+    Digest digest {};
+    EXPECT_TRUE(crypto::hashFile<Hasher>(path, digest));
+    EXPECT_EQ(expected, digest);
+
+    // empty regular file, nothing to map
+    ASSERT_EQ(0, truncate(path, 0));
+    EXPECT_TRUE(crypto::hashFile<Hasher>(path, digest));
+    EXPECT_EQ(empty, digest);
+    unlink(path);
+
+    // pipe, neither mappable nor seekable
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(static_cast<ssize_t>(text.length()), write(fds[1], text.data(), text.length()));
+    close(fds[1]);
+    EXPECT_TRUE(crypto::hashFile<Hasher>("/proc/self/fd/" + std::to_string(fds[0]), digest));
+    EXPECT_EQ(expected, digest);
+    close(fds[0]);
+
+    EXPECT_TRUE(crypto::hashFile<Hasher>("/dev/null", digest));
+    EXPECT_EQ(empty, digest);
+
+    digest = expected;
+    EXPECT_FALSE(crypto::hashFile<Hasher>("/nonexistent/test-crypto", digest));
+    EXPECT_EQ(expected, digest);
+}
+
+template <typename Hasher>
+void asyncHashFilesProve(const std::string& text)
+{
+    using Digest = decltype(std::declval<Hasher&>().getHash());
+
+    // regular files from empty to several chunks (with 4 KiB reads), a pipe and failures
+    std::string big;
+    while (big.size() < 40000) {
+        big += text;
+    }
+
+    std::vector<std::string> paths;
+    std::vector<std::string> contents;
+    for (size_t size : { size_t(0), size_t(1), size_t(4095), size_t(4097), big.size() }) {
+        char path[] = "/tmp/test-crypto-XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(static_cast<ssize_t>(size), write(fd, big.data(), size));
+        close(fd);
+        paths.push_back(path);
+        contents.push_back(big.substr(0, size));
+    }
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(static_cast<ssize_t>(text.length()), write(fds[1], text.data(), text.length()));
+    close(fds[1]);
+    paths.push_back("/proc/self/fd/" + std::to_string(fds[0]));
+    contents.push_back(text);
+
+    paths.push_back("/nonexistent/test-crypto");
+    contents.push_back("");
+
+    for (bool uring : { true, false }) {
+        crypto::AsyncHashOptions options;
+        options.chunkSize = 4096;
+        options.readsPerFile = 3;
+        options.filesInFlight = 2;
+        options.useIoUring = uring;
+
+        std::mutex mutex;
+        std::vector<int> reported(paths.size(), 0);
+        std::vector<bool> succeeded(paths.size(), false);
+        std::vector<Digest> digests(paths.size());
+        std::vector<uint64_t> hashed(paths.size(), 0);
+
+        bool all = crypto::hashFilesAsync<Hasher>(paths,
+            [&](size_t index, bool ok, const Digest& digest) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++reported[index];
+                succeeded[index] = ok;
+                digests[index] = digest;
+            },
+            [&](size_t index, uint64_t done, uint64_t) {
+                std::lock_guard<std::mutex> lock(mutex);
+                hashed[index] = done;
+            },
+            options);
+
+        EXPECT_FALSE(all);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            EXPECT_EQ(1, reported[i]) << paths[i];
+            if (i + 1 == paths.size()) {
+                EXPECT_FALSE(succeeded[i]);
+                continue;
+            }
+
+            gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(contents[i].data()), static_cast<std::ptrdiff_t>(contents[i].length())};
+            Hasher reference;
+            reference.update(msg);
+            EXPECT_TRUE(succeeded[i]) << paths[i];
+            EXPECT_EQ(reference.getHash(), digests[i]) << paths[i] << (uring ? " io_uring" : " pread");
+            EXPECT_EQ(contents[i].length(), hashed[i]) << paths[i];
+        }
+
+        // the pipe is drained by the first pass
+        if (uring) {
+            contents[paths.size() - 2].clear();
+        }
+    }
+
+    close(fds[0]);
+    for (size_t i = 0; i < 5; ++i) {
+        unlink(paths[i].c_str());
+    }
+}
+
+// SHA-256 hasher counting how many of its kind are alive
+class CountedSHA256hashing
+{
+    public:
+
+        static std::atomic<size_t> alive;
+        static std::atomic<size_t> mostAlive;
+
+        CountedSHA256hashing(void)
+        {
+            auto now = ++alive;
+            auto most = mostAlive.load();
+            while (now > most && !mostAlive.compare_exchange_weak(most, now)) {}
+        }
+        ~CountedSHA256hashing() { --alive; }
+
+        bool update(gsl::span<const uint8_t> &buf) { return m_hasher.update(buf); }
+        crypto::SHA256hash getHash(void) { return m_hasher.getHash(); }
+
+    private:
+
+        crypto::SHA256hashing m_hasher;
+};
+
+std::atomic<size_t> CountedSHA256hashing::alive {0};
+std::atomic<size_t> CountedSHA256hashing::mostAlive {0};
+
+void asyncHashFilesInFlightProve(const std::string& text)
+{
+    // many more files than are open at once
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 40; ++i) {
+        char path[] = "/tmp/test-crypto-XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(static_cast<ssize_t>(i * 50), write(fd, text.data(), i * 50));
+        close(fd);
+        paths.push_back(path);
+    }
+
+    for (bool uring : { true, false }) {
+        crypto::AsyncHashOptions options;
+        options.chunkSize = 4096;
+        options.filesInFlight = 3;
+        options.useIoUring = uring;
+
+        CountedSHA256hashing::mostAlive = 0;
+        size_t matching = 0;
+        EXPECT_TRUE(crypto::hashFilesAsync<CountedSHA256hashing>(paths,
+            [&](size_t index, bool ok, const crypto::SHA256hash& digest) {
+                gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(index * 50)};
+                crypto::SHA256hashing reference;
+                reference.update(msg);
+                matching += ok && reference.getHash() == digest;
+            },
+            nullptr, options));
+        EXPECT_EQ(paths.size(), matching);
+        EXPECT_EQ(0u, CountedSHA256hashing::alive.load());
+        EXPECT_LE(CountedSHA256hashing::mostAlive.load(), options.filesInFlight);
+        EXPECT_GE(CountedSHA256hashing::mostAlive.load(), 1u);
+    }
+
+    for (const auto& path : paths) {
+        unlink(path.c_str());
+    }
+}
+
+#if defined(CRYPTO_TESTING)
+void asyncHashFilesUringErrorProve(const std::string& text)
+{
+    std::string data;
+    while (data.size() < 3 * 4096 + 100) {
+        data += text;
+    }
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 10; ++i) {
+        char path[] = "/tmp/test-crypto-XXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(static_cast<ssize_t>(data.size() - i), write(fd, data.data(), data.size() - i));
+        close(fd);
+        paths.push_back(path);
+    }
+
+    crypto::AsyncHashOptions options;
+    options.chunkSize = 4096;
+    options.readsPerFile = 2;
+    options.filesInFlight = 3;
+    options.useIoUring = true;
+
+    // the ring breaks down with its first reads in flight
+    crypto::file_detail::injectUringError(ENOMEM);
+    std::vector<int> reported(paths.size(), 0);
+    size_t succeeded = 0;
+    bool all = crypto::hashFilesAsync<crypto::SHA256hashing>(paths,
+        [&](size_t index, bool ok, const crypto::SHA256hash& digest) {
+            ++reported[index];
+            if (!ok) {
+                return;
+            }
+            gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(data.data()), static_cast<std::ptrdiff_t>(data.size() - index)};
+            crypto::SHA256hashing reference;
+            reference.update(msg);
+            EXPECT_EQ(reference.getHash(), digest) << paths[index];
+            ++succeeded;
+        },
+        nullptr, options);
+    crypto::file_detail::injectUringError(0);
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        EXPECT_EQ(1, reported[i]) << paths[i];
+    }
+    // only the files open when it failed are lost, threads read the others
+    EXPECT_GE(succeeded, paths.size() - options.filesInFlight);
+    EXPECT_EQ(succeeded == paths.size(), all);
+
+    for (const auto& path : paths) {
+        unlink(path.c_str());
+    }
+}
+#endif
+
+template <typename StaticHasher, typename Hasher>
+void staticHashProve(const std::string& text)
+{
+    gsl::span<const uint8_t> whole {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+
+    // around the padding boundaries of both block sizes, then the whole text in chunks
+    for (std::ptrdiff_t len : { 0, 1, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 1000 }) {
+        auto msg = whole.first(len);
+
+        Hasher reference;
+        StaticHasher hasher;
+        if (!msg.empty()) {
+            EXPECT_TRUE(reference.update(msg));
+            EXPECT_TRUE(hasher.update(msg));
+        }
+        EXPECT_EQ(reference.getHash(), hasher.getHash()) << len << " bytes";
+    }
+
+    Hasher reference;
+    EXPECT_TRUE(reference.update(whole));
+    auto expected = reference.getHash();
+
+    for (std::ptrdiff_t chunkSize : { 1, 3, 64, 65, 200 }) {
+        StaticHasher hasher;
+        auto in = whole;
+        while (!in.empty()) {
+            auto chunk = in.first(std::min(chunkSize, in.size()));
+            EXPECT_TRUE(hasher.update(chunk));
+            in = in.subspan(chunk.size());
+        }
+        EXPECT_EQ(expected, hasher.getHash()) << "chunks of " << chunkSize;
+    }
+
+    // a copy forks the running hash
+    StaticHasher hasher;
+    auto head = whole.first(100), tail = whole.subspan(100);
+    EXPECT_TRUE(hasher.update(head));
+    auto fork = hasher;
+    EXPECT_TRUE(hasher.update(tail));
+    EXPECT_TRUE(fork.update(tail));
+    EXPECT_EQ(expected, hasher.getHash());
+    EXPECT_EQ(expected, fork.getHash());
+}
+
+template <typename Hasher>
+void resumeHashProve(const std::string& text)
+{
+    gsl::span<const uint8_t> whole {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+
+    Hasher reference;
+    EXPECT_TRUE(reference.update(whole));
+    auto expected = reference.getHash();
+
+    for (std::ptrdiff_t split : { 1, 63, 64, 65, 127, 128, 129, 500 }) {
+        auto head = whole.first(split), tail = whole.subspan(split);
+
+        Hasher prefix;
+        EXPECT_TRUE(prefix.update(head));
+        auto expectedPrefix = prefix.getHash();
+
+        // a clone gives the digest of the prefix while the original goes on
+        Hasher hasher;
+        EXPECT_TRUE(hasher.update(head));
+        auto fork = hasher.clone();
+        EXPECT_EQ(expectedPrefix, fork.getHash()) << "prefix of " << split << " bytes";
+
+        // checkpoint, resumed by another hasher
+        std::vector<uint8_t> state;
+        EXPECT_TRUE(hasher.exportState(state));
+        EXPECT_TRUE(hasher.update(tail));
+        EXPECT_EQ(expected, hasher.getHash()) << "split at " << split;
+
+        Hasher resumed;
+        EXPECT_TRUE(resumed.importState(state));
+        EXPECT_TRUE(resumed.update(tail));
+        EXPECT_EQ(expected, resumed.getHash()) << "resumed at " << split;
+
+        // malformed checkpoints are rejected
+        auto truncated = gsl::span<const uint8_t>(state).first(static_cast<std::ptrdiff_t>(state.size()) - 1);
+        EXPECT_FALSE(resumed.importState(truncated));
+        state[5] ^= 0xFF;
+        EXPECT_FALSE(resumed.importState(state));
+    }
+}
+
+template <typename Hasher>
+void hmacProve(const std::vector<std::string>& expected)
+{
+    // RFC 2202 / RFC 4231 test cases 1, 2 and 6 (key longer than a block), then an empty message
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        { std::string(20, '\x0b'), "Hi There" },
+        { "Jefe", "what do ya want for nothing?" },
+        { std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First" },
+        { "key", "" }
+    };
+    ASSERT_EQ(cases.size(), expected.size());
+
+    auto bytes = [](const std::string& s) {
+        return gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(s.data()), static_cast<std::ptrdiff_t>(s.length()));
+    };
+    auto hex = [](const decltype(std::declval<Hasher&>().getHash())& mac) {
+        std::stringstream ss;
+        ss << gsl::span<const uint8_t>(mac);
+        return ss.str();
+    };
+
+    for (size_t i = 0; i < cases.size(); ++i) {
+        crypto::HMAC<Hasher> hmac(bytes(cases[i].first));
+        auto msg = bytes(cases[i].second);
+
+        EXPECT_EQ(expected[i], hex(hmac.sign(msg))) << "case " << i;
+
+        // the keyed state is reused, streaming gives the same MAC
+        auto in = msg;
+        while (!in.empty()) {
+            auto chunk = in.first(std::min<std::ptrdiff_t>(5, in.size()));
+            EXPECT_TRUE(hmac.update(chunk));
+            in = in.subspan(chunk.size());
+        }
+        EXPECT_EQ(expected[i], hex(hmac.getHash())) << "streamed case " << i;
+    }
+
+    crypto::HMAC<Hasher> hmac(bytes("Jefe"));
+    std::vector<gsl::span<const uint8_t>> msgs(3, bytes(cases[1].second));
+    std::vector<decltype(std::declval<Hasher&>().getHash())> macs(msgs.size());
+    EXPECT_TRUE(hmac.signMany(msgs, macs));
+    for (auto& mac : macs) {
+        EXPECT_EQ(expected[1], hex(mac));
+    }
+    EXPECT_FALSE(hmac.signMany(msgs, gsl::span<decltype(std::declval<Hasher&>().getHash())>(macs).first(1)));
+}
+
+void sha1KernelsProve(const std::string& text)
+{
+    // every SHA-1 kernel the host can run must agree with the portable rounds, whatever the
+    // dispatcher of SHA1hashing picks
+    const auto* blocks = reinterpret_cast<const uint8_t*>(text.data());
+    const size_t nblocks = text.length() / 64;
+    ASSERT_GE(nblocks, 3u);
+
+    auto expected = crypto::sha1_detail::IV;
+    crypto::sha1_detail::compress(expected, blocks, nblocks);
+
+    uint32_t wk[2][80];
+
+    if (crypto::sha1_detail::hasSSSE3()) {
+        auto state = crypto::sha1_detail::IV;
+        for (size_t i = 0; i < nblocks; ++i) {
+            crypto::sha1_detail::expandSSSE3(blocks + 64 * i, wk[0]);
+            crypto::sha1_detail::compressExpanded(state, wk[0]);
+        }
+        EXPECT_EQ(expected, state);
+    }
+
+    if (crypto::sha1_detail::hasAVX2()) {
+        auto state = crypto::sha1_detail::IV;
+        size_t i = 0;
+        for (; i + 2 <= nblocks; i += 2) {
+            crypto::sha1_detail::expandAVX2(blocks + 64 * i, wk[0], wk[1]);
+            crypto::sha1_detail::compressExpanded(state, wk[0]);
+            crypto::sha1_detail::compressExpanded(state, wk[1]);
+        }
+        crypto::sha1_detail::compress(state, blocks + 64 * i, nblocks - i);
+        EXPECT_EQ(expected, state);
+    }
+
+    if (crypto::sha1_detail::hasSHANI()) {
+        auto state = crypto::sha1_detail::IV;
+        crypto::sha1_detail::processBlocksSHANI(state.data(), blocks, nblocks);
+        EXPECT_EQ(expected, state);
+    }
+}
+
+void sha512KernelsProve(const std::string& text)
+{
+    const auto* blocks = reinterpret_cast<const uint8_t*>(text.data());
+    const size_t nblocks = text.length() / 128;
+    ASSERT_GE(nblocks, 2u);
+
+    auto expected = crypto::sha512384_detail::IV512;
+    crypto::sha512384_detail::compress(expected, blocks, nblocks);
+
+    if (crypto::sha512384_detail::hasAVX2()) {
+        auto state = crypto::sha512384_detail::IV512;
+        crypto::sha512384_detail::processBlocksAVX2(state.data(), blocks, nblocks);
+        EXPECT_EQ(expected, state);
+    }
+}
+
+template <typename Hasher>
+void dispatchProve(const std::string& text)
+{
+    Hasher hasher;
+    const auto algo = hasher.algorithm();
+    gsl::span<const uint8_t> message {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+
+    hasher.update(message);
+    const auto expected = hasher.getHash();
+
+    // every kernel the host runs gives the same digest once forced
+    const auto kernels = crypto::dispatch::available(algo);
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_EQ("portable", kernels.back());
+
+    for (const auto& kernel : kernels) {
+        EXPECT_TRUE(crypto::dispatch::force(algo, kernel));
+        EXPECT_EQ(kernel, crypto::dispatch::selected(algo));
+
+        hasher.update(message);
+        EXPECT_EQ(expected, hasher.getHash()) << kernel;
+    }
+
+    // unknown kernels leave the binding alone
+    EXPECT_FALSE(crypto::dispatch::force(algo, "no-such-kernel"));
+    EXPECT_EQ(kernels.back(), crypto::dispatch::selected(algo));
+
+    EXPECT_TRUE(crypto::dispatch::force(algo, "auto"));
+    EXPECT_EQ(kernels.front(), crypto::dispatch::selected(algo));
+}
+
+template <typename Hasher>
+void hasherPoolProve(const std::string& text)
+{
+    using Pool = crypto::HasherPool<Hasher>;
+
+    gsl::span<const uint8_t> message {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+    auto head = message.first(message.size() / 2);
+    auto tail = message.subspan(head.size());
+
+    Hasher reference;
+    reference.update(message);
+    const auto expected = reference.getHash();
+    const auto empty = reference.getHash();
+
+    // the block cipher lives in the hasher: moving it carries the running hash along
+    Hasher first;
+    first.update(head);
+    Hasher second(std::move(first));
+    second.update(tail);
+    EXPECT_EQ(expected, second.getHash());
+
+    Pool::reserve(2);
+    EXPECT_EQ(2u, Pool::idle());
+
+    // the counter sees the allocations made in the libraries, or the check below proves nothing
+    {
+        const auto counted = g_allocations.load();
+        std::ostringstream out;
+        out << text;
+        EXPECT_LT(counted, g_allocations.load());
+    }
+
+    // steady state: no allocation at all, neither for the pool nor for a hasher on the stack
+    const auto before = g_allocations.load();
+    bool same = true;
+    for (int i = 0; i < 100; ++i) {
+        auto lease = Pool::acquire();
+        lease->update(head);
+        if (i % 2 == 0) {
+            lease->update(tail);
+            same = same && lease->getHash() == expected;
+        }
+        Hasher local;
+        local.update(message);
+        same = same && local.getHash() == expected;
+    }
+    EXPECT_EQ(before, g_allocations.load());
+    EXPECT_TRUE(same);
+
+    // released hashers come back reset, whatever their state
+    {
+        auto a = Pool::acquire();
+        auto b = Pool::acquire();
+        EXPECT_EQ(0u, Pool::idle());
+        EXPECT_EQ(empty, a->getHash());
+        EXPECT_EQ(empty, b->getHash());
+
+        // a lease released by another thread joins the pool of that thread
+        std::thread([lease = std::move(b)]() mutable {
+            auto moved = std::move(lease);
+        }).join();
+    }
+    EXPECT_EQ(1u, Pool::idle());
+}
+
+template <typename Hasher, typename OneShot>
+void oneShotProve(const std::string& text, OneShot oneShot)
+{
+    gsl::span<const uint8_t> whole {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(text.length())};
+
+    // every tail length around one and two blocks, for 64 and 128 bytes blocks
+    bool same = true;
+    for (std::ptrdiff_t size = 0; size <= 300; ++size) {
+        auto msg = whole.first(size);
+        Hasher hasher;
+        EXPECT_TRUE(hasher.update(msg));
+        same = same && hasher.getHash() == oneShot(msg);
+    }
+    EXPECT_TRUE(same);
+
+    Hasher hasher;
+    EXPECT_TRUE(hasher.update(whole));
+    EXPECT_EQ(hasher.getHash(), oneShot(whole));
+
+    // the empty message, even without any data pointer
+    gsl::span<const uint8_t> none;
+    EXPECT_TRUE(hasher.update(none));
+    EXPECT_EQ(hasher.getHash(), oneShot(none));
+
+    const auto before = g_allocations.load();
+    auto digest = oneShot(whole);
+    EXPECT_EQ(before, g_allocations.load());
+    EXPECT_FALSE(digest.empty());
+}
+
+void multiDigestProve(const std::string& text)
+{
+    using crypto::HashAlgorithm;
+
+    // large enough for several pool windows
+    std::vector<uint8_t> message;
+    while (message.size() < (1u << 20) + 333) {
+        message.insert(message.end(), text.begin(), text.end());
+    }
+    gsl::span<const uint8_t> whole {message.data(), static_cast<std::ptrdiff_t>(message.size())};
+
+    auto check = [](const crypto::MultiDigest::Digests& digests, gsl::span<const uint8_t> msg) {
+        EXPECT_EQ(crypto::md5(msg), digests.md5);
+        EXPECT_EQ(crypto::sha1(msg), digests.sha1);
+        EXPECT_EQ(crypto::sha256(msg), digests.sha256);
+        EXPECT_EQ(crypto::sha512(msg), digests.sha512);
+        // not requested
+        EXPECT_EQ(crypto::MD4hash {}, digests.md4);
+        EXPECT_EQ(crypto::SHA384hash {}, digests.sha384);
+    };
+
+    crypto::ThreadPool pool(3);
+    for (auto usePool : { false, true }) {
+        crypto::MultiDigest multi({ HashAlgorithm::SHA512, HashAlgorithm::MD5, HashAlgorithm::SHA1,
+                                    HashAlgorithm::SHA256, HashAlgorithm::MD5 }, usePool ? &pool : nullptr);
+        EXPECT_EQ((std::vector<HashAlgorithm> { HashAlgorithm::MD5, HashAlgorithm::SHA1,
+                                                 HashAlgorithm::SHA256, HashAlgorithm::SHA512 }), multi.algorithms());
+        EXPECT_FALSE(multi.has(HashAlgorithm::SHA384));
+
+        // all at once, then in pieces straddling blocks and slices
+        EXPECT_TRUE(multi.update(whole));
+        check(multi.getHashes(), whole);
+
+        for (std::ptrdiff_t offset = 0, step = 1; offset < whole.size(); offset += step, step = step * 3 + 7) {
+            auto piece = whole.subspan(offset, std::min(step, whole.size() - offset));
+            EXPECT_TRUE(multi.update(piece));
+        }
+        auto digests = multi.getHashes();
+        check(digests, whole);
+        auto bytes = digests[HashAlgorithm::SHA256];
+        EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), digests.sha256.begin(), digests.sha256.end()));
+        EXPECT_TRUE(digests[HashAlgorithm::UNKNOWN].empty());
+
+        // the empty message, and reset() dropping what was hashed
+        auto head = whole.first(100);
+        EXPECT_TRUE(multi.update(head));
+        multi.reset();
+        gsl::span<const uint8_t> none;
+        EXPECT_TRUE(multi.update(none));
+        check(multi.getHashes(), none);
+    }
+
+    // no allocation without a pool, the windows of the pool each allocate their batch
+    crypto::MultiDigest multi({ HashAlgorithm::MD5, HashAlgorithm::SHA1, HashAlgorithm::SHA256 });
+    const auto before = g_allocations.load();
+    EXPECT_TRUE(multi.update(whole));
+    auto digests = multi.getHashes();
+    EXPECT_EQ(before, g_allocations.load());
+    EXPECT_EQ(crypto::sha1(whole), digests.sha1);
+}
+
+void hexProve(void)
+{
+    std::vector<uint8_t> bytes(200);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 167 + 13);
+    }
+
+    // every length around the vector widths, against the stream output
+    for (std::ptrdiff_t size = 0; size <= 200; ++size) {
+        gsl::span<const uint8_t> msg {bytes.data(), size};
+        std::ostringstream stream;
+        stream << msg;
+
+        std::string text(2 * size, '?');
+        crypto::toHex(msg, &text[0]);
+        EXPECT_EQ(stream.str(), text);
+
+        std::string upper(text);
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        std::vector<uint8_t> decoded(size);
+        EXPECT_TRUE(crypto::fromHex(gsl::span<const char>(upper.data(), upper.size()), decoded.data()));
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), msg.begin()));
+
+        // a bad character anywhere, vector or tail, is refused
+        for (size_t i = 0; i < text.size(); i += 7) {
+            for (auto bad : { 'g', 'G', '/', ':', '@', '`', ' ', '\x80' }) {
+                std::string wrong(text);
+                wrong[i] = bad;
+                EXPECT_FALSE(crypto::fromHex(gsl::span<const char>(wrong.data(), wrong.size()), decoded.data())) << i << bad;
+            }
+        }
+        if (size > 0) {
+            EXPECT_FALSE(crypto::fromHex(gsl::span<const char>(text.data(), text.size() - 1), decoded.data()));
+        }
+    }
+
+    // every kernel the host has, whatever was selected
+    std::string reference(128, '?');
+    crypto::hex_detail::encode(bytes.data(), 64, &reference[0]);
+    std::string text(128, '?');
+    std::vector<uint8_t> decoded(64);
+    if (crypto::hex_detail::hasSSSE3()) {
+        crypto::hex_detail::encodeSSSE3(bytes.data(), 64, &text[0]);
+        EXPECT_EQ(reference, text);
+        EXPECT_TRUE(crypto::hex_detail::decodeSSSE3(text.data(), 64, decoded.data()));
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), bytes.begin()));
+    }
+    if (crypto::hex_detail::hasAVX2()) {
+        crypto::hex_detail::encodeAVX2(bytes.data(), 64, &text[0]);
+        EXPECT_EQ(reference, text);
+        EXPECT_TRUE(crypto::hex_detail::decodeAVX2(text.data(), 64, decoded.data()));
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), bytes.begin()));
+    }
+
+    // the digest sizes through each kernel the host has, and what is left after its vectors
+    std::vector<crypto::hex_detail::Kernel> available { crypto::hex_detail::Kernel::PORTABLE };
+    if (crypto::hex_detail::hasSSSE3()) {
+        available.push_back(crypto::hex_detail::Kernel::SSSE3);
+    }
+    if (crypto::hex_detail::hasSSSE3() && crypto::hex_detail::hasAVX2()) {
+        available.push_back(crypto::hex_detail::Kernel::AVX2);
+    }
+    EXPECT_EQ(available.back(), crypto::hex_detail::widest());
+    for (auto kernel : available) {
+        for (size_t size : { 16, 20, 28, 32, 48, 64 }) {
+            crypto::hex_detail::encode(bytes.data(), size, &reference[0]);
+            std::string encoded(2 * size, '?');
+            crypto::hex_detail::encode(kernel, bytes.data(), size, &encoded[0]);
+            EXPECT_EQ(reference.substr(0, 2 * size), encoded) << size;
+
+            std::vector<uint8_t> back(size);
+            EXPECT_TRUE(crypto::hex_detail::decode(kernel, encoded.data(), size, back.data())) << size;
+            EXPECT_TRUE(std::equal(back.begin(), back.end(), bytes.begin())) << size;
+
+            // in the vectors as in the tail
+            encoded[0] = 'x';
+            EXPECT_FALSE(crypto::hex_detail::decode(kernel, encoded.data(), size, back.data())) << size;
+            encoded[0] = reference[0];
+            encoded.back() = 'x';
+            EXPECT_FALSE(crypto::hex_detail::decode(kernel, encoded.data(), size, back.data())) << size;
+        }
+    }
+
+    // digests
+    crypto::SHA256hashing hasher;
+    auto digest = hasher.getHash();
+    auto hex = crypto::toHex(digest);
+    EXPECT_STREQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", hex.data());
+
+    crypto::SHA256hash parsed {};
+    EXPECT_TRUE(crypto::fromHex(gsl::span<const char>(hex.data(), 64), parsed));
+    EXPECT_EQ(digest, parsed);
+    EXPECT_TRUE(crypto::equals(digest, parsed));
+    EXPECT_FALSE(crypto::fromHex(gsl::span<const char>(hex.data(), 62), parsed));
+    EXPECT_EQ(digest, parsed);
+
+    parsed[31] ^= 1;
+    EXPECT_FALSE(crypto::equals(digest, parsed));
+    parsed[31] ^= 1;
+    parsed[0] ^= 0x80;
+    EXPECT_FALSE(crypto::equals(digest, parsed));
+    EXPECT_FALSE(crypto::equals(gsl::span<const uint8_t>(digest), gsl::span<const uint8_t>(digest).first(31)));
+    EXPECT_TRUE(crypto::equals(gsl::span<const uint8_t>(), gsl::span<const uint8_t>()));
+
+    const auto before = g_allocations.load();
+    auto again = crypto::toHex(digest);
+    EXPECT_TRUE(crypto::fromHex(gsl::span<const char>(again.data(), 64), parsed));
+    EXPECT_EQ(before, g_allocations.load());
+}
+
+void instrumentationProve(const std::string& text)
+{
+    using crypto::HashAlgorithm;
+    namespace instrumentation = crypto::instrumentation;
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(text.data());
+    instrumentation::reset();
+
+    // 100 bytes buffered but one block, then 28 to complete the block, 15 blocks straight
+    // from the input and 12 buffered: 17 blocks, and one more for the padding
+    crypto::SHA256hashing sha256;
+    gsl::span<const uint8_t> first {p, 100};
+    gsl::span<const uint8_t> second {p + 100, 1000};
+    EXPECT_TRUE(sha256.update(first));
+    EXPECT_TRUE(sha256.update(second));
+    sha256.getHash();
+
+    // the statistics of a thread outlive it
+    std::thread([p] {
+        crypto::MD5hashing md5;
+        gsl::span<const uint8_t> msg {p, 120};
+        md5.update(msg);
+        md5.getHash();
+    }).join();
+
+    auto snapshot = instrumentation::snapshot();
+    if (!instrumentation::ENABLED) {
+        EXPECT_TRUE(snapshot.algorithms.empty());
+        return;
+    }
+
+    ASSERT_EQ(2u, snapshot.algorithms.size());
+    EXPECT_EQ(HashAlgorithm::MD5, snapshot.algorithms[0].algorithm);
+    EXPECT_EQ(nullptr, snapshot.find(HashAlgorithm::SHA1));
+
+    const auto& stats = *snapshot.find(HashAlgorithm::SHA256);
+    EXPECT_EQ(1100u, stats.bytes);
+    EXPECT_EQ(18u, stats.blocks);
+    EXPECT_EQ(3u, stats.partialCopies);
+    EXPECT_EQ(2u, stats.updates);
+    EXPECT_EQ(1u, stats.getHashes);
+    EXPECT_LE(stats.updateLatency.count, 2u);
+    EXPECT_LE(stats.getHashLatency.count, 1u);
+
+    // 120 bytes: one block, and two for the padding
+    const auto& md5 = *snapshot.find(HashAlgorithm::MD5);
+    EXPECT_EQ(120u, md5.bytes);
+    EXPECT_EQ(3u, md5.blocks);
+
+    // whatever the phase of the sampling, one call in LATENCY_SAMPLING is timed
+    instrumentation::reset();
+    crypto::SHA1hashing sha1;
+    for (unsigned i = 0; i < 4 * instrumentation::LATENCY_SAMPLING; ++i) {
+        EXPECT_TRUE(sha1.update(first));
+    }
+    auto sampled = instrumentation::snapshot();
+    const auto& latency = sampled.find(HashAlgorithm::SHA1)->updateLatency;
+    EXPECT_EQ(4u, latency.count);
+    EXPECT_LE(latency.percentile(1.0), latency.max);
+    EXPECT_GE(latency.percentile(1.0), latency.max / 8 * 7);
+    EXPECT_LE(latency.percentile(0.0), latency.percentile(1.0));
+    uint64_t inBuckets = 0;
+    for (const auto& bucket : latency.buckets) {
+        inBuckets += bucket.second;
+    }
+    EXPECT_EQ(latency.count, inBuckets);
+
+    instrumentation::reset();
+    EXPECT_TRUE(instrumentation::snapshot().algorithms.empty());
+}
+
+// the digests are constant expressions
+static_assert(crypto::ct::prefix64(crypto::ct::md5("abc")) == 0x900150983cd24fb0, "MD5 of \"abc\"");
+static_assert(crypto::ct::prefix64(crypto::ct::sha1("abc")) == 0xa9993e364706816a, "SHA-1 of \"abc\"");
+static_assert(crypto::ct::prefix64(crypto::ct::sha256("abc")) == 0xba7816bf8f01cfea, "SHA-256 of \"abc\"");
+static_assert(crypto::ct::prefix64(crypto::ct::sha256("")) == 0xe3b0c44298fc1c14, "SHA-256 of the empty message");
+
+template <typename Hasher, typename Constexpr>
+void constexprHashProve(const std::string& text, Constexpr hash)
+{
+    // every tail length around one and two padding blocks
+    bool same = true;
+    for (size_t size = 0; size <= 200 && size <= text.size(); ++size) {
+        Hasher hasher;
+        gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(text.data()), static_cast<std::ptrdiff_t>(size)};
+        EXPECT_TRUE(hasher.update(msg));
+        same = same && hasher.getHash() == hash(text.data(), size);
+    }
+    EXPECT_TRUE(same);
+}
+
+uint64_t commandIndex(const std::string& command)
+{
+    switch (crypto::ct::prefix64(crypto::sha256(gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(command.data()), command.size())))) {
+        case crypto::ct::prefix64(crypto::ct::sha256("get")): return 1;
+        case crypto::ct::prefix64(crypto::ct::sha256("set")): return 2;
+        case crypto::ct::prefix64(crypto::ct::sha256("delete")): return 3;
+        default: return 0;
+    }
+}
+
+template <typename Hasher>
+void chunkerProve(void)
+{
+    using Chunk = typename crypto::Chunker<Hasher>::Chunk;
+
+    std::vector<uint8_t> data(1 << 20);
+    uint64_t seed = 42;
+    for (auto& byte : data) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        byte = static_cast<uint8_t>(seed >> 56);
+    }
+
+    crypto::ChunkerOptions options;
+    options.minSize = 2048;
+    options.avgSize = 8192;
+    options.maxSize = 32768;
+
+    // chunks of msg given in pieces of the successive sizes of steps
+    auto chunksOf = [&](const std::vector<uint8_t>& msg, std::vector<size_t> steps, crypto::ThreadPool* pool) {
+        std::vector<Chunk> chunks;
+        crypto::Chunker<Hasher> chunker([&chunks](const Chunk& chunk) { chunks.push_back(chunk); }, options, pool);
+        size_t offset = 0;
+        for (size_t i = 0; offset < msg.size(); ++i) {
+            auto size = std::min(steps[i % steps.size()], msg.size() - offset);
+            gsl::span<const uint8_t> piece {msg.data() + offset, static_cast<std::ptrdiff_t>(size)};
+            EXPECT_TRUE(chunker.update(piece));
+            offset += size;
+        }
+        chunker.finish();
+        return chunks;
+    };
+
+    auto whole = chunksOf(data, { data.size() }, nullptr);
+    ASSERT_FALSE(whole.empty());
+    uint64_t offset = 0;
+    for (size_t i = 0; i < whole.size(); ++i) {
+        const auto& chunk = whole[i];
+        EXPECT_EQ(offset, chunk.offset);
+        EXPECT_LE(chunk.length, options.maxSize);
+        if (i + 1 < whole.size()) {
+            EXPECT_GE(chunk.length, options.minSize);
+        }
+        Hasher hasher;
+        gsl::span<const uint8_t> bytes {data.data() + chunk.offset, static_cast<std::ptrdiff_t>(chunk.length)};
+        EXPECT_TRUE(hasher.update(bytes));
+        EXPECT_EQ(hasher.getHash(), chunk.digest);
+        offset += chunk.length;
+    }
+    EXPECT_EQ(data.size(), offset);
+    EXPECT_GT(whole.size(), data.size() / options.avgSize / 2);
+    EXPECT_LT(whole.size(), data.size() / options.avgSize * 2);
+
+    // the cut points only depend on the content, not on how it is given nor who hashes it
+    auto same = [](const std::vector<Chunk>& a, const std::vector<Chunk>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Chunk& x, const Chunk& y) {
+            return x.offset == y.offset && x.length == y.length && x.digest == y.digest;
+        });
+    };
+    crypto::ThreadPool pool(3);
+    EXPECT_TRUE(same(whole, chunksOf(data, { 1, 7, 1000, 4096, 65536, 3 }, nullptr)));
+    EXPECT_TRUE(same(whole, chunksOf(data, { 100000, 1, 33333 }, &pool)));
+    EXPECT_TRUE(same(whole, chunksOf(data, { data.size() }, &pool)));
+
+    // an insertion only changes the chunks around it
+    auto shifted = data;
+    shifted.insert(shifted.begin() + 100000, { 1, 2, 3, 4, 5 });
+    auto moved = chunksOf(shifted, { 65536 }, &pool);
+    size_t found = 0;
+    for (const auto& chunk : moved) {
+        found += std::any_of(whole.begin(), whole.end(), [&chunk](const Chunk& c) { return c.digest == chunk.digest; });
+    }
+    EXPECT_GE(found + 3, moved.size());
+
+    EXPECT_TRUE(chunksOf(std::vector<uint8_t>(), { 1 }, nullptr).empty());
+}
+
+template <typename Hasher>
+void digestCacheProve(const std::string& text)
+{
+    using Digest = decltype(std::declval<Hasher&>().getHash());
+
+    auto digestOf = [](const std::string& content) {
+        Hasher hasher;
+        gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(content.data()), static_cast<std::ptrdiff_t>(content.size())};
+        EXPECT_TRUE(hasher.update(msg));
+        return hasher.getHash();
+    };
+    auto writeFile = [](const std::string& path, const std::string& content) {
+        FILE* f = fopen(path.c_str(), "wb");
+        ASSERT_NE(nullptr, f);
+        ASSERT_EQ(content.size(), fwrite(content.data(), 1, content.size(), f));
+        fclose(f);
+    };
+
+    char dir[] = "/tmp/test-crypto-XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    const std::string index = std::string(dir) + "/index";
+    const std::string file = std::string(dir) + "/file";
+    writeFile(file, text);
+
+    // files changed just now are hashed, but not recorded
+    crypto::DigestCacheOptions options;
+    options.slots = 100;
+    Digest digest {};
+    bool hit = true;
+    {
+        crypto::DigestCache racy(index, options);
+        ASSERT_TRUE(racy.valid());
+        EXPECT_TRUE(racy.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_FALSE(hit);
+        EXPECT_EQ(digestOf(text), digest);
+        EXPECT_TRUE(racy.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_FALSE(hit);
+    }
+
+    options.racyWindowNs = 0;
+    crypto::DigestCache cache(index, options);
+    ASSERT_TRUE(cache.valid());
+    EXPECT_TRUE(cache.hashFile<Hasher>(file, digest, &hit));
+    EXPECT_FALSE(hit);
+    digest = Digest {};
+    EXPECT_TRUE(cache.hashFile<Hasher>(file, digest, &hit));
+    EXPECT_TRUE(hit);
+    EXPECT_EQ(digestOf(text), digest);
+
+    // another instance, as another process would, sees the same index
+    {
+        crypto::DigestCache other(index, options);
+        digest = Digest {};
+        EXPECT_TRUE(other.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_TRUE(hit);
+        EXPECT_EQ(digestOf(text), digest);
+
+        // the digests of another algorithm are kept apart
+        crypto::MD4hash md4 {};
+        EXPECT_TRUE(other.hashFile<crypto::MD4hashing>(file, md4, &hit));
+        EXPECT_FALSE(hit);
+    }
+
+    // a new size misses
+    auto longer = text + "!";
+    writeFile(file, longer);
+    EXPECT_TRUE(cache.hashFile<Hasher>(file, digest, &hit));
+    EXPECT_FALSE(hit);
+    EXPECT_EQ(digestOf(longer), digest);
+
+    // so does a change of content of the same size, even with the mtime put back: the ctime
+    // moves on (after the tick of the previous write)
+    crypto::FileKey before;
+    ASSERT_TRUE(crypto::FileKey::of(file, before));
+    usleep(20000);
+    auto changed = longer;
+    changed[0] ^= 1;
+    writeFile(file, changed);
+    struct timespec times[2];
+    times[0].tv_sec = times[1].tv_sec = static_cast<time_t>(before.mtimeNs / 1000000000);
+    times[0].tv_nsec = times[1].tv_nsec = static_cast<long>(before.mtimeNs % 1000000000);
+    ASSERT_EQ(0, utimensat(AT_FDCWD, file.c_str(), times, 0));
+    EXPECT_TRUE(cache.hashFile<Hasher>(file, digest, &hit));
+    EXPECT_FALSE(hit);
+    EXPECT_EQ(digestOf(changed), digest);
+    EXPECT_TRUE(cache.hashFile<Hasher>(file, digest, &hit));
+    EXPECT_TRUE(hit);
+
+    // instances of several threads sharing the index, more files than slots
+    std::vector<std::string> files;
+    for (size_t i = 0; i < 300; ++i) {
+        files.push_back(std::string(dir) + "/f" + std::to_string(i));
+        writeFile(files.back(), std::to_string(i) + text.substr(0, i));
+    }
+    std::atomic<size_t> wrong {0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            crypto::DigestCache shared(index, options);
+            for (size_t round = 0; round < 2; ++round) {
+                for (size_t i = t; i < files.size() + t; ++i) {
+                    const auto n = i % files.size();
+                    Digest d {};
+                    if (!shared.hashFile<Hasher>(files[n], d) || d != digestOf(std::to_string(n) + text.substr(0, n))) {
+                        ++wrong;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0u, wrong.load());
+
+    // lookups take no lock: they go on while a store, here of another process, holds it
+    {
+        EXPECT_TRUE(cache.hashFile<Hasher>(file, digest));
+        int fd = open(index.c_str(), O_RDWR);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(0, flock(fd, LOCK_EX));
+        auto looked = std::async(std::launch::async, [&] {
+            Digest d {};
+            return cache.hashFile<Hasher>(file, d, &hit) && hit && d == digestOf(changed);
+        });
+        const bool concurrent = looked.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+        EXPECT_TRUE(concurrent);
+        flock(fd, LOCK_UN);
+        EXPECT_TRUE(looked.get());
+        close(fd);
+    }
+
+    // neither a missing file nor a pipe gets recorded
+    digest = digestOf(text);
+    EXPECT_FALSE(cache.hashFile<Hasher>(std::string(dir) + "/missing", digest));
+    EXPECT_EQ(digestOf(text), digest);
+    EXPECT_TRUE(cache.hashFile<Hasher>("/dev/null", digest, &hit));
+    EXPECT_FALSE(hit);
+    EXPECT_EQ(digestOf(""), digest);
+
+    // not an index: nothing is cached, files are still hashed
+    const std::string garbage = std::string(dir) + "/garbage";
+    writeFile(garbage, text);
+    {
+        crypto::DigestCache invalid(garbage, options);
+        EXPECT_FALSE(invalid.valid());
+        EXPECT_TRUE(invalid.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_FALSE(hit);
+        EXPECT_EQ(digestOf(changed), digest);
+    }
+
+    // an index sized but left without its header by a crash is initialized again
+    const std::string torn = std::string(dir) + "/torn";
+    {
+        int fd = open(torn.c_str(), O_RDWR | O_CREAT, 0644);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(0, ftruncate(fd, 4096 + 128 * 128));
+        close(fd);
+
+        crypto::DigestCache recovered(torn, options);
+        EXPECT_TRUE(recovered.valid());
+        EXPECT_TRUE(recovered.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_FALSE(hit);
+        EXPECT_TRUE(recovered.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_TRUE(hit);
+        EXPECT_EQ(digestOf(changed), digest);
+    }
+    {
+        crypto::DigestCache reopened(torn, options);
+        EXPECT_TRUE(reopened.valid());
+        EXPECT_TRUE(reopened.hashFile<Hasher>(file, digest, &hit));
+        EXPECT_TRUE(hit);
+    }
+
+    for (const auto& path : files) {
+        unlink(path.c_str());
+    }
+    unlink(torn.c_str());
+    unlink(garbage.c_str());
+    unlink(file.c_str());
+    unlink(index.c_str());
+    rmdir(dir);
+}
+
+// records where the data handed to it came from
+class RecordingStreambuf : public std::stringbuf
+{
+    public:
+
+        std::vector<const char*> sources;
+
+    protected:
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            sources.push_back(s);
+            return std::stringbuf::xsputn(s, n);
+        }
+};
+
+template <typename Hasher>
+void hashingStreambufProve(const std::string& text)
+{
+    // several times the default buffer, with a line break after the first copy
+    std::string data = text + "\n";
+    while (data.size() < 3 * crypto::HashingStreambuf<Hasher>::DEFAULT_BUFFER_SIZE) {
+        data += text;
+    }
+
+    Hasher reference;
+    auto digestOf = [&reference](const std::string& content) {
+        gsl::span<const uint8_t> msg {reinterpret_cast<const uint8_t*>(content.data()), static_cast<std::ptrdiff_t>(content.size())};
+        EXPECT_TRUE(reference.update(msg));
+        return reference.getHash();
+    };
+
+    for (size_t bufferSize : { size_t(1), size_t(7), size_t(64), size_t(1000), crypto::HashingStreambuf<Hasher>::DEFAULT_BUFFER_SIZE }) {
+        // writes of every size, gathered or passed through
+        RecordingStreambuf sink;
+        crypto::HashingStreambuf<Hasher> out(&sink, bufferSize);
+        {
+            std::ostream stream(&out);
+            size_t offset = 0;
+            for (size_t piece = 0; offset < data.size(); piece = (piece * 7 + 3) % 1500) {
+                const auto size = std::min(piece, data.size() - offset);
+                if (size == 1) {
+                    stream.put(data[offset]);
+                } else {
+                    stream.write(data.data() + offset, static_cast<std::streamsize>(size));
+                }
+                offset += size;
+            }
+            stream << 42 << std::flush;
+            EXPECT_TRUE(stream.good());
+        }
+        EXPECT_EQ(data + "42", sink.str());
+        EXPECT_EQ(digestOf(data + "42"), out.getHash());
+
+        // a large write is handed over from the caller's memory
+        sink.sources.clear();
+        std::ostream large(&out);
+        large.write(data.data(), static_cast<std::streamsize>(bufferSize));
+        EXPECT_EQ(1u, sink.sources.size());
+        EXPECT_TRUE(!sink.sources.empty() && sink.sources.front() == data.data());
+        EXPECT_EQ(digestOf(data.substr(0, bufferSize)), out.getHash());
+
+        // reads of every size, the digest covering what was extracted
+        std::stringbuf source(data);
+        crypto::HashingStreambuf<Hasher> in(&source, bufferSize);
+        std::istream stream(&in);
+        std::string line;
+        std::getline(stream, line);
+        EXPECT_EQ(digestOf(line + "\n"), in.getHash());
+
+        std::string rest = data.substr(line.size() + 1);
+        std::string read(rest.size(), '\0');
+        size_t offset = 0;
+        for (size_t piece = 1; offset < rest.size(); piece = (piece * 5 + 1) % 3000) {
+            const auto size = std::min(piece, rest.size() - offset);
+            stream.read(&read[offset], static_cast<std::streamsize>(size));
+            EXPECT_EQ(static_cast<std::streamsize>(size), stream.gcount());
+            offset += size;
+        }
+        EXPECT_EQ(rest, read);
+        EXPECT_EQ(std::char_traits<char>::eof(), stream.peek());
+        EXPECT_EQ(digestOf(rest), in.getHash());
+    }
+
+    // the pending output reaches the target when the buffer goes away
+    std::stringbuf sink;
+    {
+        crypto::HashingStreambuf<Hasher> out(&sink);
+        std::ostream(&out) << data;
+    }
+    EXPECT_EQ(data, sink.str());
+}
+
 TEST(BitsRotation, RotateLeftTest)
 {
     auto check_rotate_left = [](auto challenge, auto shift, auto expected) {
@@ -299,6 +1695,271 @@ TEST(Hashing, SHA512_Test)
     hashProve(challenges, crypto::SHA512hashing());
 }
 
+TEST(Hashing, ChunkedUpdate_Test)
+{
+    const auto& msg = TestEnvironment::getTxt3();
+
+    chunkedHashProve<crypto::MD4hashing>(msg);
+    chunkedHashProve<crypto::MD5hashing>(msg);
+    chunkedHashProve<crypto::SHA1hashing>(msg);
+    chunkedHashProve<crypto::SHA224hashing>(msg);
+    chunkedHashProve<crypto::SHA256hashing>(msg);
+    chunkedHashProve<crypto::SHA384hashing>(msg);
+    chunkedHashProve<crypto::SHA512hashing>(msg);
+}
+
+TEST(Hashing, MultiBuffer_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    multiBufferHashProve<crypto::MD5hashing>(text);
+    multiBufferHashProve<crypto::SHA1hashing>(text);
+    multiBufferHashProve<crypto::SHA256hashing>(text);
+    multiBufferHashProve<crypto::SHA512hashing>(text);
+}
+
+TEST(Hashing, HashRecords_Test)
+{
+    hashRecordsProve<crypto::MD5hashing>();
+    hashRecordsProve<crypto::SHA1hashing>();
+    hashRecordsProve<crypto::SHA256hashing>();
+    hashRecordsProve<crypto::SHA512hashing>();
+}
+
+TEST(Hashing, TreeHash_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    treeHashProve<crypto::SHA256hashing>(text);
+    treeHashProve<crypto::SHA512hashing>(text);
+}
+
+TEST(Hashing, HashFile_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    hashFileProve<crypto::MD5hashing>(text);
+    hashFileProve<crypto::SHA1hashing>(text);
+    hashFileProve<crypto::SHA256hashing>(text);
+    hashFileProve<crypto::SHA512hashing>(text);
+}
+
+TEST(Hashing, AsyncHashFiles_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    asyncHashFilesProve<crypto::MD5hashing>(text);
+    asyncHashFilesProve<crypto::SHA256hashing>(text);
+    asyncHashFilesProve<crypto::SHA512hashing>(text);
+    asyncHashFilesProve<crypto::TreeHashing<crypto::SHA256hashing>>(text);
+    asyncHashFilesInFlightProve(text);
+#if defined(CRYPTO_TESTING)
+    asyncHashFilesUringErrorProve(text);
+#endif
+}
+
+TEST(Hashing, ResumeHash_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    resumeHashProve<crypto::MD4hashing>(text);
+    resumeHashProve<crypto::MD5hashing>(text);
+    resumeHashProve<crypto::SHA1hashing>(text);
+    resumeHashProve<crypto::SHA224hashing>(text);
+    resumeHashProve<crypto::SHA256hashing>(text);
+    resumeHashProve<crypto::SHA384hashing>(text);
+    resumeHashProve<crypto::SHA512hashing>(text);
+
+    // states are bound to their algorithm and not available for foreign strategies
+    std::vector<uint8_t> state;
+    crypto::MD5hashing md5;
+    EXPECT_TRUE(md5.exportState(state));
+    crypto::MD4hashing md4;
+    EXPECT_FALSE(md4.importState(state));
+    crypto::DUMMYhashing dummy;
+    EXPECT_FALSE(dummy.exportState(state));
+}
+
+TEST(Hashing, HMAC_Test)
+{
+    hmacProve<crypto::MD5hashing>({
+        "5ccec34ea9656392457fa1ac27f08fbc",
+        "750c783e6ab0b503eaa86e310a5db738",
+        "bfecaf4efff90a3a668f3922fec3762d",
+        "63530468a04e386459855da0063b6596" });
+    hmacProve<crypto::SHA1hashing>({
+        "b617318655057264e28bc0b6fb378c8ef146be00",
+        "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+        "90d0dace1c1bdc957339307803160335bde6df2b",
+        "f42bb0eeb018ebbd4597ae7213711ec60760843f" });
+    hmacProve<crypto::SHA224hashing>({
+        "896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22",
+        "a30e01098bc6dbbf45690f3a7e9e6d0f8bbea2a39e6148008fd05e44",
+        "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e",
+        "5aa677c13ce1128eeb3a5c01cef7f16557cd0b76d18fd557d6ac3962" });
+    hmacProve<crypto::SHA256hashing>({
+        "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+        "5d5d139563c95b5967b9bd9a8c9b233a9dedb45072794cd232dc1b74832607d0" });
+    hmacProve<crypto::SHA384hashing>({
+        "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6",
+        "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649",
+        "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952",
+        "99f44bb4e73c9d0ef26533596c8d8a32a5f8c10a9b997d30d89a7e35ba1ccf200b985f72431202b891fe350da410e43f" });
+    hmacProve<crypto::SHA512hashing>({
+        "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cdedaa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854",
+        "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737",
+        "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598",
+        "84fa5aa0279bbc473267d05a53ea03310a987cecc4c1535ff29b6d76b8f1444a728df3aadb89d4a9a6709e1998f373566e8f824a8ca93b1821f0b69bc2a2f65e" });
+}
+
+TEST(Hashing, StaticHasher_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    staticHashProve<crypto::StaticMD4hashing, crypto::MD4hashing>(text);
+    staticHashProve<crypto::StaticMD5hashing, crypto::MD5hashing>(text);
+    staticHashProve<crypto::StaticSHA1hashing, crypto::SHA1hashing>(text);
+    staticHashProve<crypto::StaticSHA224hashing, crypto::SHA224hashing>(text);
+    staticHashProve<crypto::StaticSHA256hashing, crypto::SHA256hashing>(text);
+    staticHashProve<crypto::StaticSHA384hashing, crypto::SHA384hashing>(text);
+    staticHashProve<crypto::StaticSHA512hashing, crypto::SHA512hashing>(text);
+}
+
+TEST(Hashing, SHA1Kernels_Test)
+{
+    sha1KernelsProve(TestEnvironment::getTxt3());
+}
+
+TEST(Hashing, SHA512Kernels_Test)
+{
+    sha512KernelsProve(TestEnvironment::getTxt3());
+}
+
+/* Run by ctest with CRYPTO_KERNEL set, the overrides being applied when the library is
+ * loaded; nothing to check otherwise.
+ **/
+TEST(Hashing, DispatchEnvironment_Test)
+{
+    const char* env = std::getenv("CRYPTO_KERNEL");
+    if (env == nullptr || std::string(env) != "SHA224=portable,SHA384=portable") {
+        return;
+    }
+
+    // the names of SHA-224 and SHA-384 bind the kernels they share with SHA-256 and SHA-512
+    EXPECT_STREQ("portable", crypto::dispatch::selected(crypto::HashAlgorithm::SHA224));
+    EXPECT_STREQ("portable", crypto::dispatch::selected(crypto::HashAlgorithm::SHA256));
+    EXPECT_STREQ("portable", crypto::dispatch::selected(crypto::HashAlgorithm::SHA384));
+    EXPECT_STREQ("portable", crypto::dispatch::selected(crypto::HashAlgorithm::SHA512));
+    EXPECT_EQ(crypto::dispatch::available(crypto::HashAlgorithm::SHA1).front(),
+              crypto::dispatch::selected(crypto::HashAlgorithm::SHA1));
+}
+
+TEST(Hashing, Dispatch_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    dispatchProve<crypto::MD4hashing>(text);
+    dispatchProve<crypto::MD5hashing>(text);
+    dispatchProve<crypto::SHA1hashing>(text);
+    dispatchProve<crypto::SHA224hashing>(text);
+    dispatchProve<crypto::SHA256hashing>(text);
+    dispatchProve<crypto::SHA384hashing>(text);
+    dispatchProve<crypto::SHA512hashing>(text);
+
+    EXPECT_EQ(nullptr, crypto::dispatch::selected(crypto::HashAlgorithm::UNKNOWN));
+    EXPECT_FALSE(crypto::dispatch::force(crypto::HashAlgorithm::UNKNOWN, "portable"));
+    EXPECT_NE(std::string::npos, crypto::dispatch::describe().find("SHA256="));
+}
+
+TEST(Hashing, HasherPool_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    hasherPoolProve<crypto::MD4hashing>(text);
+    hasherPoolProve<crypto::MD5hashing>(text);
+    hasherPoolProve<crypto::SHA1hashing>(text);
+    hasherPoolProve<crypto::SHA224hashing>(text);
+    hasherPoolProve<crypto::SHA256hashing>(text);
+    hasherPoolProve<crypto::SHA384hashing>(text);
+    hasherPoolProve<crypto::SHA512hashing>(text);
+}
+
+TEST(Hashing, OneShot_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    oneShotProve<crypto::MD4hashing>(text, crypto::md4);
+    oneShotProve<crypto::MD5hashing>(text, crypto::md5);
+    oneShotProve<crypto::SHA1hashing>(text, crypto::sha1);
+    oneShotProve<crypto::SHA224hashing>(text, crypto::sha224);
+    oneShotProve<crypto::SHA256hashing>(text, crypto::sha256);
+    oneShotProve<crypto::SHA384hashing>(text, crypto::sha384);
+    oneShotProve<crypto::SHA512hashing>(text, crypto::sha512);
+}
+
+TEST(Hashing, Chunker_Test)
+{
+    chunkerProve<crypto::SHA256hashing>();
+    chunkerProve<crypto::SHA1hashing>();
+}
+
+TEST(Hashing, DigestCache_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    digestCacheProve<crypto::SHA256hashing>(text);
+    digestCacheProve<crypto::SHA1hashing>(text);
+}
+
+TEST(Hashing, HashingStreambuf_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    hashingStreambufProve<crypto::MD4hashing>(text);
+    hashingStreambufProve<crypto::MD5hashing>(text);
+    hashingStreambufProve<crypto::SHA1hashing>(text);
+    hashingStreambufProve<crypto::SHA224hashing>(text);
+    hashingStreambufProve<crypto::SHA256hashing>(text);
+    hashingStreambufProve<crypto::SHA384hashing>(text);
+    hashingStreambufProve<crypto::SHA512hashing>(text);
+    hashingStreambufProve<crypto::TreeHashing<crypto::SHA256hashing>>(text);
+}
+
+TEST(Hashing, ConstexprHash_Test)
+{
+    const auto& text = TestEnvironment::getTxt3();
+
+    constexprHashProve<crypto::MD5hashing>(text, [](const char* data, size_t size) { return crypto::ct::md5(data, size); });
+    constexprHashProve<crypto::SHA1hashing>(text, [](const char* data, size_t size) { return crypto::ct::sha1(data, size); });
+    constexprHashProve<crypto::SHA256hashing>(text, [](const char* data, size_t size) { return crypto::ct::sha256(data, size); });
+
+    constexpr auto digest = crypto::ct::sha256("The quick brown fox jumps over the lazy dog");
+    std::ostringstream stream;
+    crypto::operator<<(stream, gsl::span<const uint8_t>(digest));
+    EXPECT_EQ("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592", stream.str());
+
+    EXPECT_EQ(1u, commandIndex("get"));
+    EXPECT_EQ(3u, commandIndex("delete"));
+    EXPECT_EQ(0u, commandIndex("put"));
+}
+
+TEST(Hashing, Instrumentation_Test)
+{
+    instrumentationProve(TestEnvironment::getTxt3());
+}
+
+TEST(Hashing, Hex_Test)
+{
+    hexProve();
+}
+
+TEST(Hashing, MultiDigest_Test)
+{
+    multiDigestProve(TestEnvironment::getTxt3());
+}
+
 int main(int argc, char* argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
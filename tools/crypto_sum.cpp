@@ -0,0 +1,591 @@
+/* crypto-sum: sha256sum-style manifests of directory trees, built and checked in parallel.
+ *
+ *   crypto-sum [-a ALGO] [-j N] [-o FILE] [--cache INDEX] PATH...
+ *       prints "<digest>  <path>" for every regular file under the PATHs
+ *   crypto-sum -c [-a ALGO] [-j N] [-q] [--cache INDEX] MANIFEST...
+ *       checks the files listed in the manifests ("-" reads the standard input)
+ *   crypto-sum -t [-a ALGO] [-j N] [--cache INDEX] PATH...
+ *       prints one digest per PATH covering its whole tree
+ *
+ * ALGO is md5, sha1, sha224, sha256 (the default), sha384 or sha512; when checking, it
+ * defaults to the one whose digests have the length of the first line of the manifest.
+ *
+ * Directories are listed level by level, all the directories of a level at once on the
+ * thread pool, symbolic links to files being followed and the ones to directories not.
+ * Then the files are hashed on the pool largest first, so that no big file is left alone
+ * at the end. Manifests list the files sorted by path, the output is the same whatever the
+ * number of threads. File names with a newline or a backslash are escaped as coreutils
+ * does: the line starts with a backslash and they are written "\n" and "\\".
+ *
+ * The digest of a tree (-t) is the digest, with the same algorithm, of its manifest with
+ * the paths relative to the root of the tree: it does not depend on where the tree is, nor
+ * on the order of the directory entries.
+ *
+ * With --cache, the digests of the files unchanged since a previous run are read from the
+ * index of a DigestCache instead of the files.
+ *
+ * Exit status: 0 on success, 1 when a file could not be read or did not match, 2 on a
+ * usage error.
+ **/
+
+#include "MD5.hpp"
+#include "SHA1.hpp"
+#include "SHA224.hpp"
+#include "SHA256.hpp"
+#include "SHA384.hpp"
+#include "SHA512.hpp"
+#include "DigestCache.hpp"
+#include "HashFile.hpp"
+#include "Hex.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    enum class Mode { MANIFEST, CHECK, TREE };
+
+    struct Options
+    {
+        Mode mode = Mode::MANIFEST;
+        std::string algorithm;
+        size_t jobs = 0;
+        std::string output;
+        std::string cache;
+        bool quiet = false;
+        std::vector<std::string> paths;
+    };
+
+    struct File
+    {
+        std::string path;       // as opened
+        std::string name;       // as written in the manifest
+        uint64_t size;
+    };
+
+    void usage(FILE* out)
+    {
+        std::fputs("Usage: crypto-sum [-a ALGO] [-j N] [-o FILE] [--cache INDEX] PATH...\n"
+                   "       crypto-sum -c [-a ALGO] [-j N] [-q] [--cache INDEX] MANIFEST...\n"
+                   "       crypto-sum -t [-a ALGO] [-j N] [--cache INDEX] PATH...\n"
+                   "\n"
+                   "  -a, --algorithm ALGO  md5, sha1, sha224, sha256 (default), sha384, sha512\n"
+                   "  -c, --check           check the files listed in the manifests\n"
+                   "  -t, --tree            print one digest covering each tree\n"
+                   "  -j, --jobs N          hashing threads (default: one per hardware thread)\n"
+                   "  -o, --output FILE     write the manifest to FILE\n"
+                   "  -q, --quiet           when checking, only report the failures\n"
+                   "      --cache INDEX     reuse the digests of unchanged files kept in INDEX\n"
+                   "  -h, --help            print this help\n", out);
+    }
+
+    void error(const std::string& path, const char* what)
+    {
+        std::fprintf(stderr, "crypto-sum: %s: %s\n", path.c_str(), what);
+    }
+
+    std::string joinPath(const std::string& dir, const char* name)
+    {
+        if (!dir.empty() && dir.back() == '/') {
+            return dir + name;
+        }
+        return dir + "/" + name;
+    }
+
+    /* Lists the regular files of the trees, level by level: the directories of a level are
+     * all read at once on the pool, each into its own listing. Returns false when some
+     * directory or file could not be looked at, after reporting it.
+     **/
+    bool walk(const std::vector<std::string>& roots, crypto::ThreadPool& pool, std::vector<File>& files)
+    {
+        struct Listing
+        {
+            std::vector<File> files;
+            std::vector<File> subdirectories;   // size unused
+            bool ok = true;
+        };
+
+        bool ok = true;
+        std::vector<File> level;
+        for (const auto& root : roots) {
+            struct stat st;
+            if (::stat(root.c_str(), &st) != 0) {
+                error(root, std::strerror(errno));
+                ok = false;
+            } else if (S_ISDIR(st.st_mode)) {
+                level.push_back({ root, "", 0 });
+            } else if (S_ISREG(st.st_mode)) {
+                files.push_back({ root, root, static_cast<uint64_t>(st.st_size) });
+            } else {
+                error(root, "not a regular file nor a directory");
+                ok = false;
+            }
+        }
+
+        while (!level.empty()) {
+            std::vector<Listing> listings(level.size());
+            pool.parallelFor(level.size(), [&level, &listings](size_t i) {
+                const auto& dir = level[i];
+                auto& listing = listings[i];
+
+                std::unique_ptr<DIR, int (*)(DIR*)> handle(::opendir(dir.path.c_str()), ::closedir);
+                if (!handle) {
+                    error(dir.path, std::strerror(errno));
+                    listing.ok = false;
+                    return;
+                }
+
+                while (auto entry = ::readdir(handle.get())) {
+                    if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) {
+                        continue;
+                    }
+
+                    auto path = joinPath(dir.path, entry->d_name);
+                    auto name = dir.name.empty() ? std::string(entry->d_name) : dir.name + "/" + entry->d_name;
+                    if (entry->d_type == DT_DIR) {
+                        listing.subdirectories.push_back({ std::move(path), std::move(name), 0 });
+                        continue;
+                    }
+
+                    // links are followed to files only
+                    struct stat st;
+                    const int fd = ::dirfd(handle.get());
+                    bool link = false;
+                    if (::fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0 ||
+                        ((link = S_ISLNK(st.st_mode)) && ::fstatat(fd, entry->d_name, &st, 0) != 0)) {
+                        error(path, std::strerror(errno));
+                        listing.ok = false;
+                    } else if (S_ISREG(st.st_mode)) {
+                        listing.files.push_back({ std::move(path), std::move(name), static_cast<uint64_t>(st.st_size) });
+                    } else if (S_ISDIR(st.st_mode) && !link) {
+                        listing.subdirectories.push_back({ std::move(path), std::move(name), 0 });
+                    }
+                }
+            });
+
+            std::vector<File> next;
+            for (auto& listing : listings) {
+                ok = ok && listing.ok;
+                std::move(listing.files.begin(), listing.files.end(), std::back_inserter(files));
+                std::move(listing.subdirectories.begin(), listing.subdirectories.end(), std::back_inserter(next));
+            }
+            level.swap(next);
+        }
+        return ok;
+    }
+
+    /* Hashes the files on the pool, the largest first since the pool hands the indices out
+     * in order. ok[i] tells whether files[i] could be read.
+     **/
+    template <typename Hasher, typename Digest = decltype(std::declval<Hasher&>().getHash())>
+        void hashFiles(const std::vector<File>& files, crypto::ThreadPool& pool, crypto::DigestCache* cache,
+                       std::vector<Digest>& digests, std::vector<char>& ok)
+        {
+            std::vector<size_t> order(files.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&files](size_t a, size_t b) {
+                return files[a].size > files[b].size;
+            });
+
+            digests.assign(files.size(), Digest {});
+            ok.assign(files.size(), 0);
+            pool.parallelFor(order.size(), [&](size_t i) {
+                const auto n = order[i];
+                ok[n] = cache ? cache->hashFile<Hasher>(files[n].path, digests[n])
+                              : crypto::hashFile<Hasher>(files[n].path, digests[n]);
+            });
+        }
+
+    bool needsEscape(const std::string& name)
+    {
+        return name.find_first_of("\n\\") != std::string::npos;
+    }
+
+    std::string escape(const std::string& name)
+    {
+        std::string escaped;
+        for (char c : name) {
+            if (c == '\n') {
+                escaped += "\\n";
+            } else if (c == '\\') {
+                escaped += "\\\\";
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // "<digest>  <name>\n", escaped as coreutils does
+    template <size_t N>
+        std::string manifestLine(const crypto::CryptoHash<N>& digest, const std::string& name)
+        {
+            const bool escaped = needsEscape(name);
+            return (escaped ? "\\" : "") + std::string(crypto::toHex(digest).data()) + "  " +
+                   (escaped ? escape(name) : name) + "\n";
+        }
+
+    // name in the reports of a check, escaped the same way
+    std::string reportName(const std::string& name)
+    {
+        return needsEscape(name) ? "\\" + escape(name) : name;
+    }
+
+    bool unescape(const std::string& text, std::string& name)
+    {
+        name.clear();
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '\\') {
+                name += text[i];
+            } else if (i + 1 < text.size() && text[i + 1] == 'n') {
+                name += '\n';
+                ++i;
+            } else if (i + 1 < text.size() && text[i + 1] == '\\') {
+                name += '\\';
+                ++i;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void sortByName(std::vector<File>& files)
+    {
+        std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.name < b.name; });
+    }
+
+    template <typename Hasher>
+        int makeManifest(const Options& options, crypto::ThreadPool& pool, crypto::DigestCache* cache)
+        {
+            using Digest = decltype(std::declval<Hasher&>().getHash());
+
+            // listed by the paths they were found at, as sha256sum would
+            std::vector<File> files;
+            bool ok = walk(options.paths, pool, files);
+            for (auto& file : files) {
+                file.name = file.path;
+            }
+            sortByName(files);
+
+            std::vector<Digest> digests;
+            std::vector<char> read;
+            hashFiles<Hasher>(files, pool, cache, digests, read);
+
+            FILE* out = stdout;
+            if (!options.output.empty()) {
+                out = std::fopen(options.output.c_str(), "w");
+                if (out == nullptr) {
+                    error(options.output, std::strerror(errno));
+                    return 1;
+                }
+            }
+
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (!read[i]) {
+                    error(files[i].path, "cannot be read");
+                    ok = false;
+                    continue;
+                }
+                const auto line = manifestLine(digests[i], files[i].name);
+                std::fwrite(line.data(), 1, line.size(), out);
+            }
+
+            if (std::fflush(out) != 0 || (out != stdout && std::fclose(out) != 0)) {
+                error(options.output.empty() ? "standard output" : options.output, std::strerror(errno));
+                ok = false;
+            }
+            return ok ? 0 : 1;
+        }
+
+    template <typename Hasher>
+        int treeDigests(const Options& options, crypto::ThreadPool& pool, crypto::DigestCache* cache)
+        {
+            using Digest = decltype(std::declval<Hasher&>().getHash());
+
+            int status = 0;
+            for (const auto& root : options.paths) {
+                std::vector<File> files;
+                bool ok = walk({ root }, pool, files);
+                // a single file is a tree of one file, named after itself
+                for (auto& file : files) {
+                    if (file.name == root) {
+                        auto slash = root.find_last_of('/');
+                        file.name = (slash == std::string::npos) ? root : root.substr(slash + 1);
+                    }
+                }
+                sortByName(files);
+
+                std::vector<Digest> digests;
+                std::vector<char> read;
+                hashFiles<Hasher>(files, pool, cache, digests, read);
+
+                Hasher tree;
+                for (size_t i = 0; i < files.size(); ++i) {
+                    if (!read[i]) {
+                        error(files[i].path, "cannot be read");
+                        ok = false;
+                        continue;
+                    }
+                    const auto line = manifestLine(digests[i], files[i].name);
+                    gsl::span<const uint8_t> bytes {reinterpret_cast<const uint8_t*>(line.data()), static_cast<std::ptrdiff_t>(line.size())};
+                    tree.update(bytes);
+                }
+
+                if (!ok) {
+                    status = 1;
+                    continue;
+                }
+                const auto line = manifestLine(tree.getHash(), root);
+                std::fwrite(line.data(), 1, line.size(), stdout);
+            }
+            return status;
+        }
+
+    struct Entry
+    {
+        std::string expected;   // hexadecimal digest
+        File file;
+    };
+
+    /* Reads "<digest>  <name>" and "<digest> *<name>" lines, escaped or not. Returns false
+     * when the manifest cannot be read; the lines which do not parse are only counted.
+     **/
+    bool readManifest(const std::string& path, std::vector<Entry>& entries, size_t& malformed)
+    {
+        FILE* in = (path == "-") ? stdin : std::fopen(path.c_str(), "r");
+        if (in == nullptr) {
+            error(path, std::strerror(errno));
+            return false;
+        }
+
+        char* buffer = nullptr;
+        size_t capacity = 0;
+        ssize_t length;
+        while ((length = ::getline(&buffer, &capacity, in)) >= 0) {
+            std::string line(buffer, static_cast<size_t>(length));
+            if (!line.empty() && line.back() == '\n') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+
+            const bool escaped = line[0] == '\\';
+            const size_t digestStart = escaped ? 1 : 0;
+            const auto digestEnd = line.find(' ', digestStart);
+            if (digestEnd == std::string::npos || digestEnd == digestStart || digestEnd + 2 >= line.size() ||
+                (line[digestEnd + 1] != ' ' && line[digestEnd + 1] != '*')) {
+                ++malformed;
+                continue;
+            }
+
+            Entry entry;
+            entry.file.name = line.substr(digestEnd + 2);
+            if (escaped && !unescape(line.substr(digestEnd + 2), entry.file.name)) {
+                ++malformed;
+                continue;
+            }
+            entry.expected = line.substr(digestStart, digestEnd - digestStart);
+            entry.file.path = entry.file.name;
+            entries.push_back(std::move(entry));
+        }
+        std::free(buffer);
+
+        const bool ok = !std::ferror(in);
+        if (in != stdin) {
+            std::fclose(in);
+        }
+        if (!ok) {
+            error(path, "read error");
+        }
+        return ok;
+    }
+
+    template <typename Hasher>
+        int check(const Options& options, const std::vector<Entry>& entries, crypto::ThreadPool& pool, crypto::DigestCache* cache)
+        {
+            using Digest = decltype(std::declval<Hasher&>().getHash());
+
+            // a file missing or not regular sorts last, and fails when read
+            std::vector<File> files;
+            files.reserve(entries.size());
+            for (const auto& entry : entries) {
+                files.push_back(entry.file);
+                struct stat st;
+                files.back().size = (::stat(entry.file.path.c_str(), &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0;
+            }
+
+            std::vector<Digest> digests;
+            std::vector<char> read;
+            hashFiles<Hasher>(files, pool, cache, digests, read);
+
+            size_t unreadable = 0;
+            size_t mismatched = 0;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                Digest expected;
+                const auto& text = entries[i].expected;
+                const bool matched = read[i] &&
+                    crypto::fromHex(gsl::span<const char>(text.data(), static_cast<std::ptrdiff_t>(text.size())), expected) &&
+                    crypto::equals(expected, digests[i]);
+
+                if (!read[i]) {
+                    ++unreadable;
+                    std::printf("%s: FAILED open or read\n", reportName(entries[i].file.name).c_str());
+                } else if (!matched) {
+                    ++mismatched;
+                    std::printf("%s: FAILED\n", reportName(entries[i].file.name).c_str());
+                } else if (!options.quiet) {
+                    std::printf("%s: OK\n", reportName(entries[i].file.name).c_str());
+                }
+            }
+
+            if (unreadable > 0) {
+                std::fprintf(stderr, "crypto-sum: WARNING: %zu listed file%s could not be read\n", unreadable, unreadable > 1 ? "s" : "");
+            }
+            if (mismatched > 0) {
+                std::fprintf(stderr, "crypto-sum: WARNING: %zu computed checksum%s did NOT match\n", mismatched, mismatched > 1 ? "s" : "");
+            }
+            return (unreadable > 0 || mismatched > 0) ? 1 : 0;
+        }
+
+    template <typename Hasher>
+        int run(const Options& options, const std::vector<Entry>& entries, crypto::ThreadPool& pool, crypto::DigestCache* cache)
+        {
+            switch (options.mode) {
+                case Mode::CHECK:
+                    return check<Hasher>(options, entries, pool, cache);
+                case Mode::TREE:
+                    return treeDigests<Hasher>(options, pool, cache);
+                case Mode::MANIFEST:
+                default:
+                    return makeManifest<Hasher>(options, pool, cache);
+            }
+        }
+
+    // name of the algorithm whose digests have the given number of hexadecimal digits
+    std::string algorithmOfLength(size_t digits)
+    {
+        switch (digits) {
+            case 32: return "md5";
+            case 40: return "sha1";
+            case 56: return "sha224";
+            case 64: return "sha256";
+            case 96: return "sha384";
+            case 128: return "sha512";
+            default: return "";
+        }
+    }
+
+} /* namespace */
+
+int main(int argc, char* argv[])
+{
+    enum { OPTION_CACHE = 256 };
+    const struct option longOptions[] = {
+        { "algorithm", required_argument, nullptr, 'a' },
+        { "check", no_argument, nullptr, 'c' },
+        { "tree", no_argument, nullptr, 't' },
+        { "jobs", required_argument, nullptr, 'j' },
+        { "output", required_argument, nullptr, 'o' },
+        { "quiet", no_argument, nullptr, 'q' },
+        { "cache", required_argument, nullptr, OPTION_CACHE },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    Options options;
+    int c;
+    while ((c = ::getopt_long(argc, argv, "a:ctj:o:qh", longOptions, nullptr)) != -1) {
+        switch (c) {
+            case 'a': options.algorithm = optarg; break;
+            case 'c': options.mode = Mode::CHECK; break;
+            case 't': options.mode = Mode::TREE; break;
+            case 'j': options.jobs = static_cast<size_t>(std::strtoul(optarg, nullptr, 10)); break;
+            case 'o': options.output = optarg; break;
+            case 'q': options.quiet = true; break;
+            case OPTION_CACHE: options.cache = optarg; break;
+            case 'h': usage(stdout); return 0;
+            default: usage(stderr); return 2;
+        }
+    }
+    for (int i = optind; i < argc; ++i) {
+        options.paths.push_back(argv[i]);
+    }
+    if (options.paths.empty()) {
+        if (options.mode != Mode::CHECK) {
+            usage(stderr);
+            return 2;
+        }
+        options.paths.push_back("-");
+    }
+
+    int status = 0;
+    std::vector<Entry> entries;
+    if (options.mode == Mode::CHECK) {
+        size_t malformed = 0;
+        for (const auto& manifest : options.paths) {
+            if (!readManifest(manifest, entries, malformed)) {
+                status = 1;
+            }
+        }
+        if (options.algorithm.empty() && !entries.empty()) {
+            options.algorithm = algorithmOfLength(entries.front().expected.size());
+        }
+        if (malformed > 0) {
+            std::fprintf(stderr, "crypto-sum: WARNING: %zu line%s improperly formatted\n", malformed, malformed > 1 ? "s are" : " is");
+        }
+        if (entries.empty()) {
+            std::fprintf(stderr, "crypto-sum: no properly formatted checksum lines found\n");
+            return 1;
+        }
+    }
+    if (options.algorithm.empty()) {
+        options.algorithm = "sha256";
+    }
+
+    crypto::ThreadPool pool(options.jobs);
+    std::unique_ptr<crypto::DigestCache> cache;
+    if (!options.cache.empty()) {
+        cache.reset(new crypto::DigestCache(options.cache));
+        if (!cache->valid()) {
+            error(options.cache, "not a digest cache index, files are hashed without it");
+            cache.reset();
+        }
+    }
+
+    int result;
+    const auto& algorithm = options.algorithm;
+    if (algorithm == "md5") {
+        result = run<crypto::MD5hashing>(options, entries, pool, cache.get());
+    } else if (algorithm == "sha1") {
+        result = run<crypto::SHA1hashing>(options, entries, pool, cache.get());
+    } else if (algorithm == "sha224") {
+        result = run<crypto::SHA224hashing>(options, entries, pool, cache.get());
+    } else if (algorithm == "sha256") {
+        result = run<crypto::SHA256hashing>(options, entries, pool, cache.get());
+    } else if (algorithm == "sha384") {
+        result = run<crypto::SHA384hashing>(options, entries, pool, cache.get());
+    } else if (algorithm == "sha512") {
+        result = run<crypto::SHA512hashing>(options, entries, pool, cache.get());
+    } else {
+        std::fprintf(stderr, "crypto-sum: unknown algorithm \"%s\"\n", algorithm.c_str());
+        return 2;
+    }
+    return std::max(status, result);
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+# Checks crypto-sum end to end on a temporary tree holding names which must be escaped
+# and a symbolic link.
+#
+#   test_crypto_sum.sh CRYPTO_SUM
+
+CRYPTO_SUM="$1"
+if [ ! -x "$CRYPTO_SUM" ]; then
+    echo "usage: $0 CRYPTO_SUM" >&2
+    exit 2
+fi
+
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/test-crypto-sum-XXXXXX") || exit 2
+trap 'rm -rf "$WORK"' EXIT
+
+fail()
+{
+    echo "FAIL: $*" >&2
+    exit 1
+}
+
+tree="$WORK/tree"
+mkdir -p "$tree/sub/deeper" || exit 2
+printf 'first file\n' > "$tree/plain"
+printf 'a newline in the name\n' > "$tree/new
+line"
+printf 'a backslash in the name\n' > "$tree/back\\slash"
+printf 'deep down\n' > "$tree/sub/deeper/file"
+: > "$tree/sub/empty"
+ln -s ../plain "$tree/sub/link" || exit 2
+
+# manifest: every file, the link followed, escaped names on lines starting with a backslash
+"$CRYPTO_SUM" -o "$WORK/manifest" "$tree" || fail "manifest exited with $?"
+[ "$(wc -l < "$WORK/manifest")" -eq 6 ] || fail "manifest does not list 6 files"
+grep -q '^\\[0-9a-f]*  .*/new\\nline$' "$WORK/manifest" || fail "newline not escaped"
+grep -q '^\\[0-9a-f]*  .*/back\\\\slash$' "$WORK/manifest" || fail "backslash not escaped"
+[ "$(grep '/plain$' "$WORK/manifest" | cut -d' ' -f1)" = "$(grep '/sub/link$' "$WORK/manifest" | cut -d' ' -f1)" ] ||
+    fail "the link does not have the digest of its target"
+
+# the manifest round-trips through -c, whatever the number of threads
+"$CRYPTO_SUM" -c -q "$WORK/manifest" || fail "check of an unchanged tree exited with $?"
+"$CRYPTO_SUM" -j 1 -o "$WORK/manifest1" "$tree" || fail "manifest with -j 1 exited with $?"
+cmp -s "$WORK/manifest" "$WORK/manifest1" || fail "manifest depends on the number of threads"
+
+# the tree digest does not depend on where the tree is
+cp -R "$tree" "$WORK/copy" || exit 2
+[ -L "$WORK/copy/sub/link" ] || fail "cp did not keep the link"
+one=$("$CRYPTO_SUM" -t "$tree" | cut -d' ' -f1) || fail "tree digest exited with $?"
+two=$("$CRYPTO_SUM" -t "$WORK/copy" | cut -d' ' -f1) || fail "tree digest of the copy exited with $?"
+[ -n "$one" ] && [ "$one" = "$two" ] || fail "copies of a tree have different digests"
+
+# an edited file fails the check, and changes the tree digest
+printf 'edited\n' >> "$tree/new
+line"
+"$CRYPTO_SUM" -c -q "$WORK/manifest" > "$WORK/check" 2>&1
+status=$?
+[ $status -eq 1 ] || fail "check of an edited tree exited with $status, not 1"
+grep -q 'FAILED' "$WORK/check" || fail "the edited file is not reported"
+three=$("$CRYPTO_SUM" -t "$tree" | cut -d' ' -f1)
+[ "$one" != "$three" ] || fail "editing a file did not change the tree digest"
+
+# a usage error
+"$CRYPTO_SUM" -a nosuchalgorithm "$tree" > /dev/null 2>&1
+status=$?
+[ $status -eq 2 ] || fail "unknown algorithm exited with $status, not 2"
+
+exit 0